@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/util/util.h>
+
+DEFINE_int32(size, 1 << 20, "number of values per pass");
+DEFINE_int32(classes, 10, "row length of the softmax");
+DEFINE_int32(passes, 50, "number of passes");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+void Report(const std::string& name, double seconds, double checksum) {
+  VLOG(0) << name << ": " << 1.0 * FLAGS_size * FLAGS_passes / seconds / 1e6
+      << " M values/s (checksum " << checksum << ")";
+}
+
+double Sum(const std::vector<double>& x) {
+  double sum = 0;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    sum += x[i];
+  }
+  return sum;
+}
+
+// the scalar softmax Util used before the kernels
+void ScalarSoftmax(double* x, std::size_t n) {
+  double max = *std::max_element(x, x + n);
+  double sum = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = exp(x[i] - max);
+    sum += x[i];
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] /= sum;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  std::srand(0);
+  std::vector<double> input(FLAGS_size);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    input[i] = 20.0 * std::rand() / RAND_MAX - 10;
+  }
+  std::vector<double> x(input.size());
+  std::size_t rows = input.size() / FLAGS_classes;
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  for (int pass = 0; pass < FLAGS_passes; ++pass) {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      x[i] = std::exp(input[i]);
+    }
+  }
+  Report("std::exp", Seconds(start), Sum(x));
+
+  start = boost::posix_time::microsec_clock::local_time();
+  for (int pass = 0; pass < FLAGS_passes; ++pass) {
+    std::copy(input.begin(), input.end(), x.begin());
+    toyml::Util::Exp(&x[0], x.size());
+  }
+  Report("Util::Exp", Seconds(start), Sum(x));
+
+  start = boost::posix_time::microsec_clock::local_time();
+  for (int pass = 0; pass < FLAGS_passes; ++pass) {
+    std::copy(input.begin(), input.end(), x.begin());
+    for (std::size_t r = 0; r < rows; ++r) {
+      ScalarSoftmax(&x[r * FLAGS_classes], FLAGS_classes);
+    }
+  }
+  Report("scalar softmax", Seconds(start), Sum(x));
+
+  start = boost::posix_time::microsec_clock::local_time();
+  for (int pass = 0; pass < FLAGS_passes; ++pass) {
+    std::copy(input.begin(), input.end(), x.begin());
+    toyml::Util::Softmax(&x[0], rows, FLAGS_classes);
+  }
+  Report("Util::Softmax", Seconds(start), Sum(x));
+
+  start = boost::posix_time::microsec_clock::local_time();
+  for (int pass = 0; pass < FLAGS_passes; ++pass) {
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      x[i] = 1 / (1 + std::exp(-input[i]));
+    }
+  }
+  Report("scalar sigmoid", Seconds(start), Sum(x));
+
+  start = boost::posix_time::microsec_clock::local_time();
+  for (int pass = 0; pass < FLAGS_passes; ++pass) {
+    std::copy(input.begin(), input.end(), x.begin());
+    toyml::Util::Sigmoid(&x[0], x.size());
+  }
+  Report("Util::Sigmoid", Seconds(start), Sum(x));
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/text_cleaner.h>
+
+DEFINE_string(inpath, "/tmp/clean_bench.txt", "raw text file, generated if it does not exist");
+DEFINE_string(outpath, "/tmp/clean_bench.txt.clean", "output file of cleaned documents");
+DEFINE_int32(mbytes, 200, "size of the generated raw text in MB");
+DEFINE_int32(threads, 0, "the number of threads, 0 means using all the cores");
+
+namespace {
+
+const char* const kWords[] = {
+  "The", "market", "rallied", "after", "reports,", "showed", "running", "#growth", "in",
+  "generalization", "of", "connected", "networks.", "RT", "@user", "http://t.co/x", "happily",
+  "agreed", "to", "relational", "databases!", "a", "caresses", "ponies", "hopping", "2012",
+};
+
+void Generate(const std::string& path, std::size_t bytes) {
+  std::ofstream outf(path.c_str());
+  CHECK(outf) << "Failed to create " << path;
+  std::size_t nwords = sizeof(kWords) / sizeof(kWords[0]);
+  std::size_t size = 0;
+  std::srand(0);
+  while (size < bytes) {
+    std::string line;
+    int n = 5 + std::rand() % 20;
+    for (int i = 0; i < n; ++i) {
+      if (i > 0) line += ' ';
+      line += kWords[std::rand() % nwords];
+    }
+    line += '\n';
+    outf << line;
+    size += line.size();
+  }
+}
+
+void Run(bool stem) {
+  toyml::TextCleanerOptions options;
+  options.stem = stem;
+  options.threads = FLAGS_threads;
+  toyml::TextCleaner cleaner;
+  CHECK(cleaner.Init(options));
+  std::ifstream inf(FLAGS_inpath.c_str(), std::ios::binary | std::ios::ate);
+  double mbytes = inf.tellg() / 1e6;
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  std::size_t ndocs = 0;
+  std::size_t ntokens = 0;
+  CHECK(cleaner.CleanFile(FLAGS_inpath, FLAGS_outpath, &ndocs, &ntokens));
+  double seconds = (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+  VLOG(0) << "stem=" << stem << ": " << mbytes << "MB, docs=" << ndocs << ", tokens=" << ntokens
+      << " in " << seconds << "s, " << mbytes / seconds << "MB/s";
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  if (!std::ifstream(FLAGS_inpath.c_str())) {
+    Generate(FLAGS_inpath, FLAGS_mbytes << 20);
+  }
+  Run(false);
+  Run(true);
+
+  return 0;
+}
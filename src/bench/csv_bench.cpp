@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/data/csv.h>
+
+DEFINE_string(path, "/tmp/csv_bench.csv", "the CSV file, generated if it does not exist");
+DEFINE_int32(rows, 500000, "number of rows generated, 5000000 gives about 1 GB");
+DEFINE_int32(dimension, 20, "number of features generated per row");
+DEFINE_int32(threads, 0, "the number of threads of ReadCsvFast, 0 means all cores");
+DEFINE_string(binpath, "/tmp/csv_bench.bin", "the binary dataset written from the CSV file");
+DEFINE_bool(slow, true, "also time ReadCsv");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+bool Generate(const std::string& path) {
+  std::ofstream outf(path.c_str());
+  if (!outf) return false;
+  std::srand(0);
+  char buf[32];
+  for (int i = 0; i < FLAGS_rows; ++i) {
+    for (int j = 0; j < FLAGS_dimension; ++j) {
+      std::snprintf(buf, sizeof(buf), "%.6f,", 200.0 * std::rand() / RAND_MAX - 100);
+      outf << buf;
+    }
+    outf << std::rand() % 10 << "\n";
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  if (!std::ifstream(FLAGS_path.c_str())) {
+    CHECK(Generate(FLAGS_path)) << "Failed to write " << FLAGS_path;
+  }
+  toyml::MappedFile file;
+  CHECK(file.Open(FLAGS_path));
+  double mb = file.size() / 1e6;
+  file.Close();
+
+  toyml::ClassificationData fast;
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  CHECK(toyml::ReadCsvFast(FLAGS_path, &fast, toyml::LAST_COLUMN, toyml::kCsvDefaultSerparator,
+      toyml::kCsvDefaultComment, FLAGS_threads));
+  double seconds = Seconds(start);
+  VLOG(0) << "ReadCsvFast: " << fast.ToString() << " in " << seconds << "s, " << mb / seconds << " MB/s";
+
+  start = boost::posix_time::microsec_clock::local_time();
+  CHECK(toyml::ReadCsvFast(FLAGS_path, &fast, toyml::LAST_COLUMN, toyml::kCsvDefaultSerparator,
+      toyml::kCsvDefaultComment, 1));
+  seconds = Seconds(start);
+  VLOG(0) << "ReadCsvFast[1 thread]: " << fast.ToString() << " in " << seconds << "s, " << mb / seconds << " MB/s";
+
+  CHECK(fast.Write(FLAGS_binpath)) << "Failed to write " << FLAGS_binpath;
+  toyml::ClassificationData binary;
+  start = boost::posix_time::microsec_clock::local_time();
+  CHECK(binary.Read(FLAGS_binpath));
+  seconds = Seconds(start);
+  VLOG(0) << "ClassificationData::Read: " << binary.ToString() << " in " << seconds << "s";
+  CHECK(binary.labels() == fast.labels());
+
+  // zero copy: map the file and touch every feature
+  start = boost::posix_time::microsec_clock::local_time();
+  toyml::BinaryDataset dataset;
+  CHECK(dataset.Open(FLAGS_binpath));
+  const double* features = dataset.features<double>();
+  double sum = 0;
+  for (std::size_t i = 0; i < dataset.rows() * dataset.dimension(); ++i) {
+    sum += features[i];
+  }
+  seconds = Seconds(start);
+  VLOG(0) << "BinaryDataset::Open and one pass: " << dataset.rows() << " instances in "
+      << seconds << "s (sum " << sum << ")";
+
+  if (FLAGS_slow) {
+    toyml::ClassificationData slow;
+    start = boost::posix_time::microsec_clock::local_time();
+    CHECK(toyml::ReadCsv(FLAGS_path, &slow));
+    seconds = Seconds(start);
+    VLOG(0) << "ReadCsv: " << slow.ToString() << " in " << seconds << "s, " << mb / seconds << " MB/s";
+    CHECK(slow.labels() == fast.labels());
+  }
+
+  return 0;
+}
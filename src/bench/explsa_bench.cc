@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/plsa/ex_plsa.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_string(followeepath, "../data/explsa/followee.dat", "input file of followees, one line per document");
+DEFINE_string(datadir, "/tmp", "output data directory");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 20, "number of EM iterations");
+DEFINE_int32(threads, 0, "the number of threads");
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet document_data;
+  CHECK(document_data.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  VLOG(0) << "document_data: " << document_data.StatString();
+  toyml::DocumentSet followee_data;
+  CHECK(followee_data.Load(FLAGS_followeepath)) << "Failed to load file " << FLAGS_followeepath;
+  VLOG(0) << "followee_data: " << followee_data.StatString();
+
+  toyml::ExPLSAOptions options;
+  options.ntopics = FLAGS_topics;
+  options.niters = FLAGS_iters;
+  options.eps = -1;  // never stop early, so every run does the same number of iterations
+  options.save_interval = FLAGS_iters + 1;
+  options.threads = FLAGS_threads ? FLAGS_threads : boost::thread::hardware_concurrency();
+  options.datadir = FLAGS_datadir;
+
+  toyml::ExPLSA explsa;
+  CHECK(explsa.Init(options, document_data, followee_data));
+  VLOG(0) << "ExPLSA: " << explsa.ToString();
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  std::size_t niters = explsa.Train();
+  boost::posix_time::ptime end = boost::posix_time::microsec_clock::local_time();
+  double seconds = (end - start).total_microseconds() / 1e6;
+  VLOG(0) << "niters=" << niters << ", elapsed=" << seconds << "s, per_iter=" << seconds / niters << "s";
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/lda/gibbs_lda.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 300, "number of sweeps");
+DEFINE_int32(nlog, 10, "sweeps between convergence checks");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet dataset;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  VLOG(0) << "DocumentSet: " << dataset.StatString();
+
+  toyml::LDAOptions options;
+  options.topics = FLAGS_topics;
+  toyml::GibbsLDA lda;
+  CHECK(lda.Init(options, dataset));
+
+  const double epss[] = {1e-2, 1e-3, 1e-4};
+  const std::size_t neps = sizeof(epss) / sizeof(epss[0]);
+  std::vector<int> stops(neps, 0);
+  double sweep_seconds = 0, exact_seconds = 0, ppx_seconds = 0;
+  double pre_lik = lda.LogLikelihood();
+  for (int iter = 1; iter <= FLAGS_iters; ++iter) {
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+    lda.Sweep();
+    sweep_seconds += Seconds(start);
+    if (iter % FLAGS_nlog != 0) continue;
+
+    double lik = lda.LogLikelihood();
+    start = boost::posix_time::microsec_clock::local_time();
+    double exact = lda.ExactLogLikelihood();
+    exact_seconds += Seconds(start);
+    start = boost::posix_time::microsec_clock::local_time();
+    double ppx = lda.Perplexity();
+    ppx_seconds += Seconds(start);
+    VLOG(0) << "Iteration#" << iter << std::setprecision(10) << " L=" << lik << ", exact L=" << exact
+        << ", perplexity=" << ppx;
+    for (std::size_t i = 0; i < neps; ++i) {
+      if (stops[i] == 0 && lik - pre_lik < epss[i] * std::fabs(pre_lik)) {
+        stops[i] = iter;
+      }
+    }
+    pre_lik = lik;
+  }
+
+  int nchecks = FLAGS_iters / FLAGS_nlog;
+  VLOG(0) << "sweep=" << sweep_seconds / FLAGS_iters << "s, ExactLogLikelihood="
+      << exact_seconds / nchecks << "s, Perplexity=" << ppx_seconds / nchecks << "s";
+  for (std::size_t i = 0; i < neps; ++i) {
+    VLOG(0) << "eps=" << epss[i] << " stops at iteration#" << stops[i];
+  }
+  return 0;
+}
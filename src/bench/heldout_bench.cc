@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/heldout.h>
+#include <toyml/tm/lda/gibbs_lda.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of training documents");
+DEFINE_string(heldout, "../data/topic/newdocs.dat", "input file of held-out documents");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 50, "number of sweeps");
+DEFINE_int32(eval_interval, 5, "sweeps between held-out evaluations");
+DEFINE_int32(threads, 0, "the number of threads of the evaluator");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+// Runs iters sweeps, starting an evaluation every interval sweeps when evaluator is not NULL
+double Run(toyml::GibbsLDA* lda, toyml::HeldoutEvaluator* evaluator, int interval) {
+  boost::numeric::ublas::matrix<double> p_w_z;
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  for (int iter = 1; iter <= FLAGS_iters; ++iter) {
+    lda->Sweep();
+    if (evaluator && iter % interval == 0) {
+      lda->TopicWordProb(&p_w_z);
+      evaluator->EvaluateAsync(p_w_z, iter);
+    }
+  }
+  return Seconds(start);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet dataset, heldout;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  CHECK(heldout.Load(FLAGS_heldout)) << "Failed to load file " << FLAGS_heldout;
+  VLOG(0) << "DocumentSet: " << dataset.StatString();
+  VLOG(0) << "Held-out DocumentSet: " << heldout.StatString();
+
+  toyml::LDAOptions options;
+  options.topics = FLAGS_topics;
+  toyml::HeldoutOptions heldout_options;
+  heldout_options.alpha = options.alpha / options.topics;
+  heldout_options.threads = FLAGS_threads;
+  toyml::HeldoutEvaluator evaluator;
+  CHECK(evaluator.Init(heldout_options, dataset, heldout));
+  VLOG(0) << "HeldoutEvaluator: " << evaluator.ToString();
+
+  toyml::GibbsLDA plain;
+  CHECK(plain.Init(options, dataset));
+  double plain_seconds = Run(&plain, NULL, FLAGS_eval_interval);
+
+  toyml::GibbsLDA evaluated;
+  CHECK(evaluated.Init(options, dataset));
+  double evaluated_seconds = Run(&evaluated, &evaluator, FLAGS_eval_interval);
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  evaluator.Wait();
+  double wait_seconds = Seconds(start);
+
+  boost::numeric::ublas::matrix<double> p_w_z;
+  evaluated.TopicWordProb(&p_w_z);
+  start = boost::posix_time::microsec_clock::local_time();
+  double ppx = evaluator.Perplexity(p_w_z);
+  double eval_seconds = Seconds(start);
+
+  VLOG(0) << FLAGS_iters << " sweeps: " << plain_seconds << "s without evaluation, "
+      << evaluated_seconds << "s with an evaluation every " << FLAGS_eval_interval
+      << " sweeps, plus " << wait_seconds << "s waiting for the last one";
+  VLOG(0) << "held-out perplexity=" << std::setprecision(10) << ppx << " in " << eval_seconds << "s";
+  return 0;
+}
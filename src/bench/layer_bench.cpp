@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <string>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/dl/sigmoid_layer.h>
+
+DEFINE_int32(dimension, 256, "dimension of the inputs");
+DEFINE_int32(classes, 10, "number of outputs of the SigmoidLayer");
+DEFINE_int32(instances, 20000, "number of training instances");
+DEFINE_int32(iterations, 5, "number of passes over the instances");
+DEFINE_int32(max_batch_size, 512, "the largest batch size");
+DEFINE_double(learning_rate, 0.01, "learning rate of a single instance");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+double Accuracy(const toyml::dl::SigmoidLayer& layer, const toyml::NNetData& data,
+    const std::vector<uint32_t>& labels) {
+  toyml::ClassificationData::Outputs outputs;
+  layer.Predict(data.inputs(), &outputs);
+  std::size_t correct = 0;
+  for (std::size_t i = 0; i < labels.size(); ++i) {
+    correct += outputs[i] == labels[i];
+  }
+  return static_cast<double>(correct) / labels.size();
+}
+
+/**
+ * @brief Trains a fresh layer on train_data; batch_size 1 of NNetData is the per-instance loop
+ */
+template<typename Data>
+void Bench(const std::string& name, const Data& train_data, const toyml::NNetData& data,
+    const std::vector<uint32_t>& labels, std::size_t batch_size) {
+  toyml::dl::SigmoidLayer::Options options;
+  options.in = FLAGS_dimension;
+  options.out = FLAGS_classes;
+  options.max_iterations = FLAGS_iterations;
+  options.learning_rate = FLAGS_learning_rate;
+  options.batch_size = batch_size;
+  toyml::dl::SigmoidLayer layer;
+  CHECK(layer.Init(options));
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  CHECK(layer.Train(train_data));
+  double seconds = Seconds(start);
+  VLOG(0) << name << " batch_size=" << batch_size << ": " << FLAGS_instances * FLAGS_iterations / seconds
+      << " instances/s, training accuracy " << Accuracy(layer, data, labels);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  // the class of an instance is the largest of its first classes features
+  std::srand(0);
+  std::vector<toyml::RealVector> rows(FLAGS_instances, toyml::RealVector(FLAGS_dimension));
+  std::vector<toyml::RealVector> targets(FLAGS_instances, toyml::RealVector(FLAGS_classes, 0));
+  std::vector<uint32_t> labels(FLAGS_instances);
+  for (int i = 0; i < FLAGS_instances; ++i) {
+    for (int j = 0; j < FLAGS_dimension; ++j) {
+      rows[i](j) = static_cast<double>(std::rand()) / RAND_MAX - 0.5;
+    }
+    labels[i] = 0;
+    for (int c = 1; c < FLAGS_classes && c < FLAGS_dimension; ++c) {
+      if (rows[i](c) > rows[i](labels[i])) labels[i] = c;
+    }
+    targets[i](labels[i]) = 1;
+  }
+  toyml::NNetData data;
+  CHECK(data.Init(rows, targets));
+
+  toyml::DenseNNetData contiguous;
+  CHECK(contiguous.Init(data));
+  for (int batch_size = 1; batch_size <= FLAGS_max_batch_size; batch_size *= 4) {
+    Bench("NNetData", data, data, labels, batch_size);
+    Bench("DenseNNetData", contiguous, data, labels, batch_size);
+  }
+
+  return 0;
+}
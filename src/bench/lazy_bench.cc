@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/plsa/plsa.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 100, "number of EM iterations");
+
+namespace {
+
+/**
+ * @brief Runs the EM steps of PLSA::Train without saving the model
+ */
+class Runner : public toyml::PLSA {
+public:
+  // Returns the final log-likelihood, the seconds of the EM steps and the
+  // average fraction of documents visited per iteration
+  double Run(std::size_t iters, double* seconds, double* visited) {
+    std::srand(0);
+    InitProb();
+    *seconds = 0;
+    *visited = 0;
+    for (iter_ = 0; iter_ < iters; ++iter_) {
+      boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+      EMStep();
+      boost::posix_time::ptime end = boost::posix_time::microsec_clock::local_time();
+      *seconds += (end - start).total_microseconds() / 1e6;
+      std::size_t n = nd_;
+      if (options_.lazy_interval > 0) {
+        n = std::count(ages_.begin(), ages_.end(), 0);
+      }
+      *visited += static_cast<double>(n) / nd_ / iters;
+    }
+    return LogLikelihood();
+  }
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet dataset;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  VLOG(0) << "DocumentSet: " << dataset.StatString();
+
+  toyml::PLSAOptions options;
+  options.ntopics = FLAGS_topics;
+
+  Runner batch;
+  CHECK(batch.Init(options, dataset));
+  double batch_seconds = 0, visited = 0;
+  double batch_lik = batch.Run(FLAGS_iters, &batch_seconds, &visited);
+  VLOG(0) << "batch: L=" << std::setprecision(10) << batch_lik << ", " << batch_seconds << "s";
+
+  const std::size_t intervals[] = {5, 10};
+  const double tols[] = {1e-3, 1e-2};
+  for (std::size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); ++i) {
+    for (std::size_t j = 0; j < sizeof(tols) / sizeof(tols[0]); ++j) {
+      options.lazy_interval = intervals[i];
+      options.lazy_tol = tols[j];
+      Runner lazy;
+      CHECK(lazy.Init(options, dataset));
+      double seconds = 0;
+      double lik = lazy.Run(FLAGS_iters, &seconds, &visited);
+      VLOG(0) << "lazy_interval=" << intervals[i] << ", lazy_tol=" << tols[j] << ": L="
+          << std::setprecision(10) << lik << " (diff " << lik - batch_lik << "), " << seconds
+          << "s (" << batch_seconds / seconds << "x), visited " << visited * 100 << "% of documents";
+    }
+  }
+  return 0;
+}
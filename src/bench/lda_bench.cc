@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/lda/gibbs_lda.h>
+#include <toyml/tm/lda/cvb0_lda.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 200, "maximum number of sweeps of each engine");
+DEFINE_double(target, 0, "target perplexity, 0 means the perplexity reached by GibbsLDA after iters sweeps");
+DEFINE_int32(threads, 0, "the number of threads of CVB0LDA");
+
+namespace {
+
+/**
+ * @brief Runs iters sweeps and records the elapsed sweep time and perplexity after each one
+ */
+template<typename Engine>
+void Run(Engine* engine, std::vector<double>* seconds, std::vector<double>* ppxs) {
+  double elapsed = 0;
+  for (int iter = 0; iter < FLAGS_iters; ++iter) {
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+    engine->Sweep();
+    boost::posix_time::ptime end = boost::posix_time::microsec_clock::local_time();
+    elapsed += (end - start).total_microseconds() / 1e6;
+    seconds->push_back(elapsed);
+    ppxs->push_back(engine->Perplexity());
+  }
+}
+
+void Report(const std::string& name, const std::vector<double>& seconds,
+    const std::vector<double>& ppxs, double target) {
+  for (std::size_t i = 0; i < ppxs.size(); ++i) {
+    if (ppxs[i] <= target) {
+      VLOG(0) << name << ": reached perplexity " << ppxs[i] << " after " << i + 1
+          << " sweeps in " << seconds[i] << "s (" << seconds[i] / (i + 1) << "s/sweep)";
+      return;
+    }
+  }
+  VLOG(0) << name << ": did not reach the target in " << ppxs.size() << " sweeps ("
+      << seconds.back() << "s), final perplexity " << ppxs.back();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet dataset;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  VLOG(0) << "DocumentSet: " << dataset.StatString();
+
+  toyml::LDAOptions options;
+  options.topics = FLAGS_topics;
+  options.threads = FLAGS_threads;
+
+  std::vector<double> gibbs_seconds, gibbs_ppxs;
+  toyml::GibbsLDA gibbs;
+  CHECK(gibbs.Init(options, dataset));
+  VLOG(0) << "GibbsLDA: " << gibbs.ToString();
+  Run(&gibbs, &gibbs_seconds, &gibbs_ppxs);
+
+  std::vector<double> cvb0_seconds, cvb0_ppxs;
+  toyml::CVB0LDA cvb0;
+  CHECK(cvb0.Init(options, dataset));
+  VLOG(0) << "CVB0LDA: " << cvb0.ToString();
+  Run(&cvb0, &cvb0_seconds, &cvb0_ppxs);
+
+  double target = FLAGS_target > 0 ? FLAGS_target : gibbs_ppxs.back();
+  VLOG(0) << "target perplexity=" << std::setprecision(10) << target;
+  Report("GibbsLDA", gibbs_seconds, gibbs_ppxs, target);
+  Report("CVB0LDA", cvb0_seconds, cvb0_ppxs, target);
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <new>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/dl/hidden_layer.h>
+#include <toyml/dl/sigmoid_layer.h>
+#include <toyml/dl/neural_network.h>
+
+DEFINE_int32(dimension, 784, "dimension of the inputs");
+DEFINE_int32(hidden, 100, "number of hidden units");
+DEFINE_int32(classes, 10, "number of classes");
+DEFINE_int32(instances, 10000, "number of training instances");
+DEFINE_int32(iterations, 5, "number of passes over the instances");
+DEFINE_int32(batch_size, 64, "number of instances per update");
+DEFINE_double(learning_rate, 0.01, "learning rate");
+
+namespace {
+
+std::size_t allocations = 0;
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+}  // namespace
+
+// counts heap allocations of the training steps
+void* operator new(std::size_t size) {
+  ++allocations;
+  void* p = std::malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  // MNIST-sized: the class of an instance is the largest of its first classes features
+  std::srand(0);
+  std::vector<toyml::RealVector> rows(FLAGS_instances, toyml::RealVector(FLAGS_dimension));
+  std::vector<toyml::RealVector> targets(FLAGS_instances, toyml::RealVector(FLAGS_classes, 0));
+  std::vector<uint32_t> labels(FLAGS_instances);
+  for (int i = 0; i < FLAGS_instances; ++i) {
+    for (int j = 0; j < FLAGS_dimension; ++j) {
+      rows[i](j) = static_cast<double>(std::rand()) / RAND_MAX;
+    }
+    labels[i] = 0;
+    for (int c = 1; c < FLAGS_classes && c < FLAGS_dimension; ++c) {
+      if (rows[i](c) > rows[i](labels[i])) labels[i] = c;
+    }
+    targets[i](labels[i]) = 1;
+  }
+  toyml::NNetData data;
+  CHECK(data.Init(rows, targets));
+
+  toyml::dl::Layer::Options hidden_options;
+  hidden_options.in = FLAGS_dimension;
+  hidden_options.out = FLAGS_hidden;
+  hidden_options.learning_rate = FLAGS_learning_rate;
+  hidden_options.init_range = 0.05;
+  toyml::dl::HiddenLayer hidden;
+  CHECK(hidden.Init(hidden_options));
+  toyml::dl::Layer::Options output_options = hidden_options;
+  output_options.in = FLAGS_hidden;
+  output_options.out = FLAGS_classes;
+  toyml::dl::SigmoidLayer output;
+  CHECK(output.Init(output_options));
+
+  toyml::dl::NeuralNetwork network;
+  network.layers().push_back(&hidden);
+  network.layers().push_back(&output);
+  toyml::dl::NeuralNetwork::Options options;
+  options.batch_size = FLAGS_batch_size;
+  CHECK(network.Init(options));
+  VLOG(0) << "NeuralNetwork: " << network.ToString();
+
+  for (int iter = 0; iter < FLAGS_iterations; ++iter) {
+    std::size_t before = allocations;
+    std::size_t steps = 0;
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+    for (std::size_t begin = 0; begin < data.size(); begin += options.batch_size, ++steps) {
+      network.TrainBatch(data, begin, std::min(begin + options.batch_size, data.size()));
+    }
+    double seconds = Seconds(start);
+    std::size_t steps_allocations = allocations - before;
+
+    std::size_t correct = 0;
+    for (int i = 0; i < FLAGS_instances; ++i) {
+      toyml::ClassificationData::Output label;
+      network.Predict(data.input(i), &label);
+      correct += label == labels[i];
+    }
+    VLOG(0) << "iteration#" << iter << ": " << steps / seconds << " steps/s, "
+        << FLAGS_instances / seconds << " instances/s, " << steps_allocations
+        << " allocations in " << steps << " steps, training accuracy "
+        << static_cast<double>(correct) / FLAGS_instances;
+  }
+
+  return 0;
+}
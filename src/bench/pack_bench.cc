@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/dataset.h>
+#include <toyml/tm/plsa/plsa.h>
+#include <toyml/tm/lda/gibbs_lda.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 10, "number of PLSA iterations and Gibbs sweeps");
+DEFINE_int32(scans, 200, "number of scans over the corpus to measure decoding");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+void Run(const std::string& name, const toyml::DocumentSet& dataset) {
+  std::size_t entries = 0;
+  std::size_t tokens = dataset.TotalWordOccurs();
+  uint64_t sum = 0;
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  for (int i = 0; i < FLAGS_scans; ++i) {
+    for (uint32_t d = 0; d < dataset.DocSize(); ++d) {
+      toyml::EntryReader reader = dataset.DocReader(d);
+      for (uint32_t w, n; reader.Next(&w, &n); ) {
+        sum += w + n;
+        ++entries;
+      }
+    }
+  }
+  double decode = Seconds(start);
+  VLOG(0) << name << ": " << dataset.EntryBytes() << " bytes of entries, "
+      << static_cast<double>(dataset.EntryBytes()) / tokens << " bytes/token, decoded "
+      << entries / decode / 1e6 << "M entries/s (checksum " << sum << ")";
+
+  toyml::PLSAOptions poptions;
+  poptions.ntopics = FLAGS_topics;
+  poptions.niters = FLAGS_iters;
+  poptions.eps = -1;
+  poptions.save_interval = FLAGS_iters + 1;
+  poptions.datadir = "/tmp";
+  toyml::PLSA plsa;
+  CHECK(plsa.Init(poptions, dataset));
+  start = boost::posix_time::microsec_clock::local_time();
+  std::size_t niters = plsa.Train();
+  VLOG(0) << name << ": PLSA " << Seconds(start) / niters << "s/iteration";
+
+  toyml::LDAOptions loptions;
+  loptions.topics = FLAGS_topics;
+  toyml::GibbsLDA lda;
+  CHECK(lda.Init(loptions, dataset));
+  start = boost::posix_time::microsec_clock::local_time();
+  for (int i = 0; i < FLAGS_iters; ++i) {
+    lda.Sweep();
+  }
+  double sweep = Seconds(start) / FLAGS_iters;
+  VLOG(0) << name << ": GibbsLDA " << sweep << "s/sweep, perplexity="
+      << std::setprecision(10) << lda.Perplexity();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet dataset;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  VLOG(0) << "DocumentSet: " << dataset.StatString();
+  Run("plain", dataset);
+  dataset.Pack();
+  Run("packed", dataset);
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/data/sparse_dataset.h>
+#include <toyml/classifier/perceptron.h>
+
+DEFINE_int32(dimension, 1000000, "dimension of the sparse data");
+DEFINE_int32(dense_dimension, 10000, "dimension of the data trained both densely and sparsely");
+DEFINE_int32(dense_instances, 5000, "number of instances trained both densely and sparsely");
+DEFINE_int32(nnz, 30, "number of non-zeros per instance");
+DEFINE_int32(instances, 100000, "number of instances");
+DEFINE_int32(iters, 5, "number of training passes");
+DEFINE_double(noise, 0.05, "fraction of flipped labels, which keeps every pass running");
+DEFINE_bool(averaged, false, "whether to train an averaged perceptron");
+DEFINE_int32(max_threads, 32, "the maximum number of threads of parallel training");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+/**
+ * @brief Generates bag-of-words like data labeled by a random hyperplane
+ */
+void Generate(std::size_t dimension, std::size_t instances, toyml::SparseClassificationData* data) {
+  std::vector<double> truth(dimension);
+  for (std::size_t j = 0; j < dimension; ++j) {
+    truth[j] = static_cast<double>(std::rand()) / RAND_MAX - 0.5;
+  }
+  std::vector<std::pair<uint32_t, double> > features;
+  data->Clear();
+  for (std::size_t i = 0; i < instances; ++i) {
+    features.clear();
+    double z = 0;
+    for (int k = 0; k < FLAGS_nnz; ++k) {
+      uint32_t j = std::rand() % dimension;
+      double value = 1 + std::rand() % 3;
+      features.push_back(std::make_pair(j, value));
+      z += truth[j] * value;
+    }
+    std::sort(features.begin(), features.end());
+    bool label = z >= 0;
+    if (std::rand() < FLAGS_noise * RAND_MAX) {
+      label = !label;
+    }
+    data->Add(features, label);
+  }
+}
+
+void ToDense(const toyml::SparseClassificationData& sparse, toyml::ClassificationData* dense) {
+  std::vector<toyml::RealVector> inputs(sparse.size(), toyml::RealVector(sparse.dimension(), 0));
+  std::vector<uint32_t> labels(sparse.size());
+  for (std::size_t i = 0; i < sparse.size(); ++i) {
+    toyml::SparseVector x = sparse.input(i);
+    for (std::size_t k = 0; k < x.size(); ++k) {
+      inputs[i](x.index(k)) += x.value(k);
+    }
+    labels[i] = sparse.label(i);
+  }
+  CHECK(dense->Init(inputs, labels));
+}
+
+template<typename Data>
+void Bench(const std::string& name, const Data& data,
+    toyml::Perceptron::Mode mode = toyml::Perceptron::SERIAL, std::size_t threads = 1) {
+  toyml::Perceptron::Options options;
+  options.niters = FLAGS_iters;
+  options.averaged = FLAGS_averaged;
+  options.mode = mode;
+  options.threads = threads;
+  toyml::Perceptron m;
+  CHECK(m.Init(options));
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  CHECK(m.Train(data));
+  double train_seconds = Seconds(start);
+
+  start = boost::posix_time::microsec_clock::local_time();
+  std::size_t correct = 0;
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    toyml::Perceptron::Output y;
+    m.Predict(data.input(i), &y);
+    correct += (y == data.label(i));
+  }
+  double predict_seconds = Seconds(start);
+
+  VLOG(0) << name << ": train " << FLAGS_iters * data.size() / train_seconds << " examples/s, predict "
+      << data.size() / predict_seconds << " examples/s, training accuracy "
+      << static_cast<double>(correct) / data.size();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  std::srand(0);
+  toyml::SparseClassificationData sparse;
+  Generate(FLAGS_dense_dimension, FLAGS_dense_instances, &sparse);
+  VLOG(0) << "Data: " << sparse.ToString();
+  toyml::ClassificationData dense;
+  ToDense(sparse, &dense);
+  Bench("dense", dense);
+  toyml::DenseClassificationData contiguous;
+  CHECK(contiguous.Init(dense));
+  Bench("contiguous", contiguous);
+  Bench("sparse", sparse);
+
+  Generate(FLAGS_dimension, FLAGS_instances, &sparse);
+  VLOG(0) << "Data: " << sparse.ToString();
+  Bench("sparse", sparse);
+
+  for (int threads = 1; threads <= FLAGS_max_threads; threads *= 2) {
+    std::stringstream ss;
+    ss << "threads=" << threads;
+    Bench("hogwild " + ss.str(), sparse, toyml::Perceptron::HOGWILD, threads);
+    Bench("parameter mixing " + ss.str(), sparse, toyml::Perceptron::PARAMETER_MIXING, threads);
+  }
+
+  return 0;
+}
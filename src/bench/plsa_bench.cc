@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/plsa/plsa.h>
+#include <toyml/tm/plsa/background_plsa.h>
+#include <toyml/tm/plsa/squarem.h>
+#include <boost/bind.hpp>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 100, "number of batch EM iterations, whose log-likelihood is the target");
+DEFINE_int32(block_size, 250, "documents per p(w|z) update of incremental EM");
+DEFINE_double(lambda, 0.8, "weight of background model of BackgroundPLSA");
+
+namespace {
+
+/**
+ * @brief Exposes the EM steps of a pLSA model
+ */
+template<typename Model>
+class Runner : public Model {
+public:
+  void Begin() {
+    std::srand(0);
+    this->iter_ = 0;
+    this->InitProb();
+    lik_ = this->LogLikelihood();
+    em_steps_ = 0;
+    std::vector<toyml::ublas::matrix<double>*> params;
+    params.push_back(&this->p_z_d_);
+    params.push_back(&this->p_w_z_);
+    squarem_.reset(new toyml::Squarem(params, boost::bind(&Runner::EMStep, this),
+        boost::bind(&Runner::LogLikelihood, this)));
+  }
+  double Step() {
+    if (this->options_.accelerate) {
+      lik_ = squarem_->Iterate(lik_);
+      em_steps_ = squarem_->em_steps();
+    } else {
+      this->EMStep();
+      lik_ = this->LogLikelihood();
+      ++em_steps_;
+    }
+    ++this->iter_;
+    return lik_;
+  }
+  std::size_t em_steps() const {
+    return em_steps_;
+  }
+private:
+  double lik_;
+  std::size_t em_steps_;
+  boost::scoped_ptr<toyml::Squarem> squarem_;
+};
+
+/**
+ * @brief Runs EM until the log-likelihood reaches target or after maxiters iterations
+ */
+template<typename Model, typename Options>
+double Run(const std::string& name, const Options& options, const toyml::DocumentSet& dataset,
+    std::size_t maxiters, double target) {
+  Runner<Model> model;
+  CHECK(model.Init(options, dataset));
+  model.Begin();
+  double elapsed = 0;
+  double lik = 0;
+  std::size_t iter = 0;
+  while (iter < maxiters) {
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+    lik = model.Step();
+    boost::posix_time::ptime end = boost::posix_time::microsec_clock::local_time();
+    elapsed += (end - start).total_microseconds() / 1e6;
+    ++iter;
+    if (lik >= target) break;
+  }
+  VLOG(0) << name << ": L=" << std::setprecision(10) << lik << " after " << iter
+      << " iterations (" << model.em_steps() << " EM steps) in " << elapsed << "s";
+  return lik;
+}
+
+template<typename Model, typename Options>
+void Compare(const std::string& name, Options options, const toyml::DocumentSet& dataset) {
+  options.block_size = 0;
+  double target = Run<Model>(name + "[batch]", options, dataset, FLAGS_iters, 0);
+  options.block_size = FLAGS_block_size;
+  Run<Model>(name + "[incremental]", options, dataset, FLAGS_iters, target);
+  options.block_size = 0;
+  options.accelerate = true;
+  Run<Model>(name + "[squarem]", options, dataset, FLAGS_iters, target);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet dataset;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  VLOG(0) << "DocumentSet: " << dataset.StatString();
+
+  toyml::PLSAOptions options;
+  options.ntopics = FLAGS_topics;
+  Compare<toyml::PLSA>("PLSA", options, dataset);
+
+  toyml::BackgroundPLSAOptions boptions;
+  boptions.ntopics = FLAGS_topics;
+  boptions.lambda = FLAGS_lambda;
+  Compare<toyml::BackgroundPLSA>("BackgroundPLSA", boptions, dataset);
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/classifier/perceptron.h>
+#include <toyml/dl/sigmoid_layer.h>
+
+DEFINE_int32(dimension, 100, "dimension of the inputs");
+DEFINE_int32(classes, 10, "number of outputs of the SigmoidLayer");
+DEFINE_int32(instances, 65536, "number of inputs predicted");
+DEFINE_int32(max_batch_size, 4096, "the largest batch size");
+DEFINE_int32(threads, 0, "the number of threads, 0 means all cores");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+void Report(const std::string& name, std::size_t batch_size, double seconds) {
+  VLOG(0) << name << " batch_size=" << batch_size << ": " << FLAGS_instances / seconds << " predictions/s";
+}
+
+/**
+ * @brief Predicts one input at a time, as the models did before batching
+ */
+template<typename Model, typename Outputs>
+void BenchSingle(const std::string& name, const Model& m, const toyml::Data<toyml::RealVector>& inputs,
+    Outputs* outputs) {
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  outputs->resize(inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    m.Predict(inputs[i], &(*outputs)[i]);
+  }
+  Report(name + "[single]", 1, Seconds(start));
+}
+
+template<typename Model, typename Outputs>
+void BenchBatch(const std::string& name, Model* m, const toyml::Data<toyml::RealVector>& inputs,
+    Outputs* outputs) {
+  m->set_predict_threads(FLAGS_threads);
+  for (int batch_size = 1; batch_size <= FLAGS_max_batch_size; batch_size *= 2) {
+    m->set_predict_block_size(batch_size);
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+    m->Predict(inputs, outputs);
+    Report(name, batch_size, Seconds(start));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  std::srand(0);
+  std::vector<toyml::RealVector> rows(FLAGS_instances, toyml::RealVector(FLAGS_dimension));
+  std::vector<uint32_t> labels(FLAGS_instances);
+  for (int i = 0; i < FLAGS_instances; ++i) {
+    for (int j = 0; j < FLAGS_dimension; ++j) {
+      rows[i](j) = static_cast<double>(std::rand()) / RAND_MAX - 0.5;
+    }
+    labels[i] = rows[i](0) + rows[i](1) > 0;
+  }
+  toyml::ClassificationData data;
+  CHECK(data.Init(rows, labels));
+
+  toyml::Perceptron perceptron;
+  CHECK(perceptron.Init(toyml::Perceptron::Options()));
+  CHECK(perceptron.Train(data));
+  toyml::Perceptron::Outputs labels_out;
+  BenchSingle("Perceptron", perceptron, data.inputs(), &labels_out);
+  BenchBatch("Perceptron", &perceptron, data.inputs(), &labels_out);
+
+  toyml::dl::SigmoidLayer::Options options;
+  options.in = FLAGS_dimension;
+  options.out = FLAGS_classes;
+  toyml::dl::SigmoidLayer layer;
+  CHECK(layer.Init(options));
+  toyml::ClassificationData::Outputs classes_out;
+  BenchSingle("SigmoidLayer", layer, data.inputs(), &classes_out);
+  BenchBatch("SigmoidLayer", &layer, data.inputs(), &classes_out);
+  toyml::dl::SigmoidLayer::Outputs probs_out;
+  BenchSingle("SigmoidLayer[probs]", layer, data.inputs(), &probs_out);
+  BenchBatch("SigmoidLayer[probs]", &layer, data.inputs(), &probs_out);
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/plsa/plsa.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_int32(topics, 30, "number of topics");
+DEFINE_int32(iters, 100, "number of EM iterations");
+DEFINE_int32(prune_after, 50, "iterations between prunings of p(w|z)");
+
+namespace {
+
+/**
+ * @brief Runs the EM steps of PLSA::Train without saving the model
+ */
+class Runner : public toyml::PLSA {
+public:
+  // Returns the final log-likelihood, and the seconds of the iterations after warmup
+  double Run(std::size_t iters, std::size_t warmup, double* seconds) {
+    std::srand(0);
+    InitProb();
+    *seconds = 0;
+    for (iter_ = 0; iter_ < iters; ++iter_) {
+      if (options_.prune_after > 0 && iter_ > 0 && iter_ % options_.prune_after == 0) {
+        PruneTopics();
+      }
+      boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+      EMStep();
+      boost::posix_time::ptime end = boost::posix_time::microsec_clock::local_time();
+      if (iter_ >= warmup) {
+        *seconds += (end - start).total_microseconds() / 1e6;
+      }
+    }
+    return LogLikelihood();
+  }
+  std::size_t entries() const {
+    return sparse() ? topics_.size() : nw_ * nz_;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::DocumentSet dataset;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  VLOG(0) << "DocumentSet: " << dataset.StatString();
+
+  toyml::PLSAOptions options;
+  options.ntopics = FLAGS_topics;
+  int timed = FLAGS_iters - FLAGS_prune_after;
+
+  Runner dense;
+  CHECK(dense.Init(options, dataset));
+  double dense_seconds = 0;
+  double dense_lik = dense.Run(FLAGS_iters, FLAGS_prune_after, &dense_seconds);
+  VLOG(0) << "dense: L=" << std::setprecision(10) << dense_lik << ", "
+      << dense_seconds / timed << "s/iteration";
+
+  const double tols[] = {1e-12, 1e-8, 1e-6};
+  for (std::size_t i = 0; i < sizeof(tols) / sizeof(tols[0]); ++i) {
+    options.prune_after = FLAGS_prune_after;
+    options.prune_tol = tols[i];
+    Runner pruned;
+    CHECK(pruned.Init(options, dataset));
+    double seconds = 0;
+    double lik = pruned.Run(FLAGS_iters, FLAGS_prune_after, &seconds);
+    VLOG(0) << "prune_tol=" << tols[i] << ": L=" << std::setprecision(10) << lik
+        << " (diff " << lik - dense_lik << "), " << seconds / timed << "s/iteration ("
+        << dense_seconds / seconds << "x), " << pruned.entries() << " of "
+        << dataset.DictSize() * FLAGS_topics << " entries";
+  }
+  return 0;
+}
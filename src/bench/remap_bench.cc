@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/lda/gibbs_lda.h>
+#include <toyml/tm/plsa/ex_plsa.h>
+
+DEFINE_string(docpath, "../data/topic/trndocs.dat", "input file of documents");
+DEFINE_string(followeepath, "../data/explsa/followee.dat", "input file of followees, one line per document");
+DEFINE_string(datadir, "/tmp", "output data directory");
+DEFINE_int32(topics, 100, "number of topics");
+DEFINE_int32(sweeps, 20, "number of Gibbs sweeps");
+DEFINE_int32(iters, 10, "number of ExPLSA EM iterations");
+
+namespace {
+
+double Seconds(const boost::posix_time::ptime& start) {
+  return (boost::posix_time::microsec_clock::local_time() - start).total_microseconds() / 1e6;
+}
+
+void RunGibbs(bool remap) {
+  toyml::DocumentSet dataset;
+  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  if (remap) {
+    dataset.RemapByFrequency();
+  }
+  toyml::LDAOptions options;
+  options.topics = FLAGS_topics;
+  toyml::GibbsLDA lda;
+  CHECK(lda.Init(options, dataset));
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  for (int i = 0; i < FLAGS_sweeps; ++i) {
+    lda.Sweep();
+  }
+  double seconds = Seconds(start);
+  VLOG(0) << "GibbsLDA[remap=" << remap << "]: " << seconds / FLAGS_sweeps << "s/sweep, perplexity="
+      << std::setprecision(10) << lda.Perplexity();
+}
+
+void RunExPLSA(bool remap) {
+  toyml::DocumentSet document_data;
+  CHECK(document_data.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+  toyml::DocumentSet followee_data;
+  CHECK(followee_data.Load(FLAGS_followeepath)) << "Failed to load file " << FLAGS_followeepath;
+  if (remap) {
+    document_data.RemapByFrequency();
+    followee_data.RemapByFrequency();
+  }
+  toyml::ExPLSAOptions options;
+  options.ntopics = FLAGS_topics;
+  options.niters = FLAGS_iters;
+  options.eps = -1;  // never stop early, so both runs do the same number of iterations
+  options.save_interval = FLAGS_iters + 1;
+  options.threads = boost::thread::hardware_concurrency();
+  options.datadir = FLAGS_datadir;
+  toyml::ExPLSA explsa;
+  CHECK(explsa.Init(options, document_data, followee_data));
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  std::size_t niters = explsa.Train();
+  double seconds = Seconds(start);
+  VLOG(0) << "ExPLSA[remap=" << remap << "]: " << seconds / niters << "s/iteration";
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  RunGibbs(false);
+  RunGibbs(true);
+  RunExPLSA(false);
+  RunExPLSA(true);
+
+  return 0;
+}
@@ -24,6 +24,7 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <glog/logging.h>
 #include <gflags/gflags.h>
 
@@ -33,6 +34,7 @@
 
 DEFINE_string(trainpath, "data/classifier/train.csv", "the training data file");
 DEFINE_string(testpath, "data/classifier/test.csv", "the test data file");
+DEFINE_int32(chunk_size, 0, "if positive, stream the training data in chunks of this many rows");
 
 int main(int argc, char **argv) {
   FLAGS_stderrthreshold = 0;
@@ -44,18 +46,27 @@ int main(int argc, char **argv) {
 
   VLOG(0) << "------" << argv[0] << "------";
 
-  toyml::ClassificationData train;
   toyml::ClassificationData test;
-  CHECK(toyml::ReadCsv(FLAGS_trainpath, &train));
   CHECK(toyml::ReadCsv(FLAGS_testpath, &test));
-  VLOG(0) << "Training data: " << train.ToString();
   VLOG(0) << "Test data: " << test.ToString();
 
   toyml::Perceptron::Options options;
   options.niters = 100;
   toyml::Perceptron m;
   CHECK(m.Init(options));
-  CHECK(m.Train(train)) << "Failed to train " << m.name() << " model.";
+  if (FLAGS_chunk_size > 0) {
+    for (std::size_t iter = 0; iter < options.niters; ++iter) {
+      std::ifstream inf(FLAGS_trainpath.c_str());
+      std::size_t rows = m.StreamTrain(inf, FLAGS_chunk_size);
+      CHECK(rows > 0) << "Failed to train " << m.name() << " model.";
+      VLOG(1) << "pass#" << iter << ": rows=" << rows;
+    }
+  } else {
+    toyml::ClassificationData train;
+    CHECK(toyml::ReadCsv(FLAGS_trainpath, &train));
+    VLOG(0) << "Training data: " << train.ToString();
+    CHECK(m.Train(train)) << "Failed to train " << m.name() << " model.";
+  }
   toyml::Perceptron::Outputs outputs = m(test.inputs());
 
   toyml::ConfusionMatrix cm;
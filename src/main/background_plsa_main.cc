@@ -29,6 +29,13 @@ DEFINE_int32(log_interval, 10, "log interval");
 DEFINE_int32(save_interval, 40, "save interval");
 DEFINE_string(datadir, "../data/bplsa/", "output data directory");
 DEFINE_bool(random, false, "whether to randomly initialize probability");
+DEFINE_bool(accelerate, false, "whether to accelerate EM with SQUAREM");
+DEFINE_int32(min_df, 1, "drop words occurring in fewer documents");
+DEFINE_double(max_df, 1.0, "drop words occurring in more than this fraction of documents");
+DEFINE_int32(max_words, 0, "keep at most the max_words most frequent words, 0 means no limit");
+DEFINE_string(stopwords, "", "path of a stopword list whose words are dropped");
+DEFINE_int32(block_size, 0, "documents per p(w|z) update of incremental EM, 0 means batch EM");
+DEFINE_bool(pack, false, "whether to pack the documents and posting lists to save memory");
 
 int main(int argc, char **argv) {
   FLAGS_stderrthreshold = 0;
@@ -41,10 +48,21 @@ int main(int argc, char **argv) {
   toyml::DocumentSet dataset;
   CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
   VLOG(0) << "docpath=" << FLAGS_docpath;
+  toyml::PruneOptions prune;
+  prune.min_df = FLAGS_min_df;
+  prune.max_df = FLAGS_max_df;
+  prune.max_words = FLAGS_max_words;
+  prune.stopwords = FLAGS_stopwords;
+  if (prune.Enabled()) {
+    CHECK(dataset.Prune(prune)) << "Failed to prune " << FLAGS_docpath;
+  }
   CHECK(dataset.SaveDetailedDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
   CHECK(dataset.SaveTopFreqWord(FLAGS_top_wordpath, FLAGS_topn_word)) << "Failed to save top word probabilities file " << FLAGS_top_wordpath;
-  VLOG(0) << "dataset.StatString: " << dataset.StatString();
-  VLOG(4) << "dataset.Doc(0): " << dataset.Doc(0).ToString();
+  if (FLAGS_pack) {
+    dataset.Pack();
+  }
+  VLOG(0) << "dataset.StatString: " << dataset.StatString() << ", EntryBytes=" << dataset.EntryBytes();
+  VLOG(4) << "dataset.DocString(0): " << dataset.DocString(0);
 
   toyml::BackgroundPLSAOptions options;
   options.ntopics = FLAGS_topics;
@@ -56,6 +74,8 @@ int main(int argc, char **argv) {
   options.save_interval = FLAGS_save_interval;
   options.datadir = FLAGS_datadir;
   options.random = FLAGS_random;
+  options.accelerate = FLAGS_accelerate;
+  options.block_size = FLAGS_block_size;
   VLOG(0) << "options: " << options.ToString();
 
   toyml::BackgroundPLSA bplsa;
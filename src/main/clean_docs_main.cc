@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include <iostream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <glog/logging.h>
+#include <gflags/gflags.h>
+
+#include <toyml/tm/text_cleaner.h>
+
+DEFINE_string(inpath, "tweet_docs.dat", "input file of raw text, one document per line");
+DEFINE_string(outpath, "", "output file of cleaned documents, empty means inpath.clean");
+DEFINE_string(stopwords, "stopwords.dat", "stopword list, empty means none");
+DEFINE_bool(stem, false, "whether to reduce words to their Porter stems");
+DEFINE_int32(min_length, 2, "drop words shorter than this");
+DEFINE_int32(threads, 0, "the number of threads, 0 means using all the cores");
+
+int main(int argc, char **argv) {
+  FLAGS_stderrthreshold = 0;
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  VLOG(0) << "------" << argv[0] << "------";
+
+  toyml::TextCleanerOptions options;
+  options.stopwords = FLAGS_stopwords;
+  options.stem = FLAGS_stem;
+  options.min_length = FLAGS_min_length;
+  options.threads = FLAGS_threads;
+  VLOG(0) << "options: " << options.ToString();
+
+  toyml::TextCleaner cleaner;
+  CHECK(cleaner.Init(options)) << "Failed to init the text cleaner";
+  std::string outpath = FLAGS_outpath.empty() ? FLAGS_inpath + ".clean" : FLAGS_outpath;
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+  std::size_t ndocs = 0;
+  std::size_t ntokens = 0;
+  CHECK(cleaner.CleanFile(FLAGS_inpath, outpath, &ndocs, &ntokens)) << "Failed to clean " << FLAGS_inpath;
+  boost::posix_time::ptime end = boost::posix_time::microsec_clock::local_time();
+  VLOG(0) << "outpath=" << outpath << ", docs=" << ndocs << ", all_tokens=" << ntokens
+      << ", elapsed=" << (end - start).total_microseconds() / 1e6 << "s";
+
+  return 0;
+}
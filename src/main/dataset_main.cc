@@ -6,6 +6,7 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <glog/logging.h>
 #include <gflags/gflags.h>
 
@@ -13,6 +14,8 @@
 
 DEFINE_string(docpath, "../data/topic/testdocs.dat", "input file of documents");
 DEFINE_string(dictpath, "../data/topic/dict.dat", "output file of dictionary");
+DEFINE_string(binpath, "", "if set, stream docpath into this binary corpus file instead of loading it");
+DEFINE_int32(batch_size, 100000, "number of documents converted at a time");
 
 int main(int argc, char **argv) {
   FLAGS_stderrthreshold = 0;
@@ -22,6 +25,20 @@ int main(int argc, char **argv) {
   VLOG(0) << "------" << argv[0] << "------";
 
   toyml::DocumentSet dataset;
+  if (!FLAGS_binpath.empty()) {
+    std::ifstream inf(FLAGS_docpath.c_str());
+    CHECK(inf) << "Failed to open file " << FLAGS_docpath;
+    std::ofstream outf(FLAGS_binpath.c_str(), std::ios::binary);
+    CHECK(outf) << "Failed to create file " << FLAGS_binpath;
+    std::size_t ndocs = 0;
+    while (std::size_t n = dataset.LoadNext(inf, FLAGS_batch_size)) {
+      CHECK(dataset.WriteBinary(outf)) << "Failed to write file " << FLAGS_binpath;
+      ndocs += n;
+    }
+    CHECK(dataset.SaveDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
+    VLOG(0) << "binpath=" << FLAGS_binpath << ", DocSize=" << ndocs << ", DicSize=" << dataset.DictSize();
+    return 0;
+  }
   CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
   VLOG(0) << "docpath=" << FLAGS_docpath;
   CHECK(dataset.SaveDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
@@ -28,7 +28,14 @@ DEFINE_int32(save_interval, 40, "save interval");
 DEFINE_int32(threads, 0, "the number of threads");
 DEFINE_string(datadir, "../data/explsa/", "output data directory");
 DEFINE_bool(random, false, "whether to randomly initialize probability");
+DEFINE_bool(accelerate, false, "whether to accelerate EM with SQUAREM");
 DEFINE_bool(super_celebrity, true, "whether to introduce the super celebrity");
+DEFINE_bool(remap, false, "whether to renumber words and celebrities by descending frequency");
+DEFINE_int32(min_df, 1, "drop words occurring in fewer documents");
+DEFINE_double(max_df, 1.0, "drop words occurring in more than this fraction of documents");
+DEFINE_int32(max_words, 0, "keep at most the max_words most frequent words, 0 means no limit");
+DEFINE_string(stopwords, "", "path of a stopword list whose words are dropped");
+DEFINE_bool(pack, false, "whether to pack the documents and posting lists to save memory");
 
 int main(int argc, char **argv) {
   FLAGS_stderrthreshold = 0;
@@ -41,14 +48,34 @@ int main(int argc, char **argv) {
   toyml::DocumentSet document_data;
   CHECK(document_data.Load(FLAGS_docpath)) << "Failed to load document file " << FLAGS_docpath;
   VLOG(0) << "docpath=" << FLAGS_docpath;
+  toyml::PruneOptions prune;
+  prune.min_df = FLAGS_min_df;
+  prune.max_df = FLAGS_max_df;
+  prune.max_words = FLAGS_max_words;
+  prune.stopwords = FLAGS_stopwords;
+  if (prune.Enabled()) {
+    CHECK(document_data.Prune(prune)) << "Failed to prune " << FLAGS_docpath;
+  }
+  if (FLAGS_remap) {
+    document_data.RemapByFrequency();
+  }
   CHECK(document_data.SaveDetailedDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
-  VLOG(0) << "document_data: " << document_data.StatString();
+  if (FLAGS_pack) {
+    document_data.Pack();
+  }
+  VLOG(0) << "document_data: " << document_data.StatString() << ", EntryBytes=" << document_data.EntryBytes();
 
   toyml::DocumentSet followee_data;
   CHECK(followee_data.Load(FLAGS_followeepath)) << "Failed to load followee file " << FLAGS_followeepath;
   VLOG(0) << "followeepath=" << FLAGS_followeepath;
+  if (FLAGS_remap) {
+    followee_data.RemapByFrequency();
+  }
   CHECK(followee_data.SaveDetailedDict(FLAGS_celpath)) << "Failed to save celebrities file " << FLAGS_dictpath;
-  VLOG(0) << "followee_data: " << followee_data.StatString();
+  if (FLAGS_pack) {
+    followee_data.Pack();
+  }
+  VLOG(0) << "followee_data: " << followee_data.StatString() << ", EntryBytes=" << followee_data.EntryBytes();
 
   toyml::ExPLSAOptions options;
   options.ntopics = FLAGS_topics;
@@ -61,6 +88,7 @@ int main(int argc, char **argv) {
   options.threads = FLAGS_threads ? FLAGS_threads : boost::thread::hardware_concurrency();
   options.datadir = FLAGS_datadir;
   options.random = FLAGS_random;
+  options.accelerate = FLAGS_accelerate;
   options.super_celebrity = FLAGS_super_celebrity;
   VLOG(0) << "options: " << options.ToString();
 
@@ -10,7 +10,9 @@
 #include <glog/logging.h>
 #include <gflags/gflags.h>
 
+#include <toyml/tm/lda/lda.h>
 #include <toyml/tm/lda/gibbs_lda.h>
+#include <toyml/tm/lda/cvb0_lda.h>
 
 DECLARE_int32(stderrthreshold);
 //DECLARE_string(log_dir);
@@ -18,13 +20,27 @@ DECLARE_int32(stderrthreshold);
 DEFINE_string(docpath, "../data/lda/doc.dat", "input file of documents");
 DEFINE_string(dictpath, "../data/lda/dict.dat", "output file of dictionary");
 
+DEFINE_string(engine, "gibbs", "training engine: gibbs, cvb0 or online");
 DEFINE_int32(topics, 10, "number of topics");
 DEFINE_int32(iters, 100, "number of iterators");
-DEFINE_double(eps, 0.1, "EPS");
+DEFINE_double(eps, 1e-3, "stop when the relative improvement over nlog sweeps falls below eps");
 DEFINE_int32(nlog, 10, "log interval");
 DEFINE_int32(nsave, 40, "save interval");
+DEFINE_int32(threads, 0, "the number of threads, 0 means using all the cores");
+DEFINE_int32(batch_size, 256, "documents per mini-batch of online LDA");
+DEFINE_double(tau0, 1024, "delay of the learning rate of online LDA");
+DEFINE_double(kappa, 0.7, "forgetting rate of online LDA");
+DEFINE_string(model, "", "suffix of the saved online LDA model to continue training");
 DEFINE_string(datadir, "../data/lda/", "output data directory");
 DEFINE_bool(random, false, "whether to randomly initialize probability");
+DEFINE_string(heldout, "", "held-out documents whose perplexity is evaluated in the background during training");
+DEFINE_int32(eval_interval, 10, "sweeps between held-out evaluations");
+DEFINE_bool(remap, false, "whether to renumber words by descending frequency");
+DEFINE_int32(min_df, 1, "drop words occurring in fewer documents");
+DEFINE_double(max_df, 1.0, "drop words occurring in more than this fraction of documents");
+DEFINE_int32(max_words, 0, "keep at most the max_words most frequent words, 0 means no limit");
+DEFINE_string(stopwords, "", "path of a stopword list whose words are dropped");
+DEFINE_bool(pack, false, "whether to pack the documents and posting lists to save memory");
 
 int main(int argc, char **argv) {
   FLAGS_stderrthreshold = 0;
@@ -34,30 +50,86 @@ int main(int argc, char **argv) {
 
   VLOG(0) << "------" << argv[0] << "------";
 
-  toyml::DocumentSet dataset;
-  CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
-  VLOG(0) << "docpath=" << FLAGS_docpath;
-  CHECK(dataset.SaveDetailedDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
-  VLOG(0) << "DocumentSet: " << dataset.StatString();
-
   toyml::LDAOptions options;
   options.topics = FLAGS_topics;
   options.iters = FLAGS_iters;
   options.eps = FLAGS_eps;
   options.nlog = FLAGS_nlog;
   options.nsave = FLAGS_nsave;
+  options.threads = FLAGS_threads;
+  options.batch_size = FLAGS_batch_size;
+  options.tau0 = FLAGS_tau0;
+  options.kappa = FLAGS_kappa;
   options.datadir = FLAGS_datadir;
   options.random = FLAGS_random;
   VLOG(0) << "LDAOptions: " << options.ToString();
 
-  toyml::GibbsLDA lda;
-  CHECK(lda.Init(options, dataset));
-  VLOG(0) << "GibbsLDA: " << lda.ToString();
-
   boost::posix_time::ptime start =
       boost::posix_time::microsec_clock::local_time();
 
-  std::size_t niters = lda.Train();
+  std::size_t niters = 0;
+  if (FLAGS_engine == "online") {
+    // documents are streamed from docpath, so the corpus is never loaded as a whole
+    CHECK(FLAGS_min_df <= 1 && FLAGS_max_df >= 1.0 && FLAGS_max_words == 0 &&
+        FLAGS_stopwords.empty() && !FLAGS_remap && FLAGS_heldout.empty() && !FLAGS_pack)
+        << "--min_df, --max_df, --max_words, --stopwords, --remap, --heldout and --pack "
+        << "are not supported with --engine=online";
+    toyml::LDA lda;
+    CHECK(lda.Init(options));
+    if (!FLAGS_model.empty()) {
+      CHECK(lda.LoadModel(FLAGS_model)) << "Failed to load model " << FLAGS_model;
+    }
+    niters = lda.Train(FLAGS_docpath);
+    CHECK(lda.dataset().SaveDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
+  } else {
+    toyml::DocumentSet dataset;
+    CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
+    VLOG(0) << "docpath=" << FLAGS_docpath;
+    toyml::PruneOptions prune;
+    prune.min_df = FLAGS_min_df;
+    prune.max_df = FLAGS_max_df;
+    prune.max_words = FLAGS_max_words;
+    prune.stopwords = FLAGS_stopwords;
+    if (prune.Enabled()) {
+      CHECK(dataset.Prune(prune)) << "Failed to prune " << FLAGS_docpath;
+    }
+    if (FLAGS_remap) {
+      dataset.RemapByFrequency();
+    }
+    CHECK(dataset.SaveDetailedDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
+    if (FLAGS_pack) {
+      dataset.Pack();
+    }
+    VLOG(0) << "DocumentSet: " << dataset.StatString() << ", EntryBytes=" << dataset.EntryBytes();
+
+    toyml::DocumentSet heldout;
+    toyml::HeldoutEvaluator evaluator;
+    toyml::HeldoutEvaluator* eval = NULL;
+    if (!FLAGS_heldout.empty()) {
+      CHECK(heldout.Load(FLAGS_heldout)) << "Failed to load file " << FLAGS_heldout;
+      toyml::HeldoutOptions heldout_options;
+      heldout_options.alpha = options.alpha / options.topics;
+      heldout_options.threads = options.threads;
+      CHECK(evaluator.Init(heldout_options, dataset, heldout));
+      VLOG(0) << "HeldoutEvaluator: " << evaluator.ToString();
+      eval = &evaluator;
+    }
+
+    if (FLAGS_engine == "cvb0") {
+      toyml::CVB0LDA lda;
+      CHECK(lda.Init(options, dataset));
+      lda.set_evaluator(eval, FLAGS_eval_interval);
+      VLOG(0) << "CVB0LDA: " << lda.ToString();
+      niters = lda.Train();
+    } else {
+      CHECK(FLAGS_engine == "gibbs") << "Unknown engine " << FLAGS_engine;
+      toyml::GibbsLDA lda;
+      CHECK(lda.Init(options, dataset));
+      lda.set_evaluator(eval, FLAGS_eval_interval);
+      VLOG(0) << "GibbsLDA: " << lda.ToString();
+      niters = lda.Train();
+    }
+  }
 
   boost::posix_time::ptime end =
       boost::posix_time::microsec_clock::local_time();
@@ -11,6 +11,7 @@
 #include <gflags/gflags.h>
 
 #include <toyml/tm/plsa/plsa.h>
+#include <toyml/tm/plsa/stream_plsa.h>
 
 DECLARE_int32(stderrthreshold);
 //DECLARE_string(log_dir);
@@ -25,6 +26,36 @@ DEFINE_int32(log_interval, 10, "log interval");
 DEFINE_int32(save_interval, 40, "save interval");
 DEFINE_string(datadir, "../data/plsa/", "output data directory");
 DEFINE_bool(random, false, "whether to randomly initialize probability");
+DEFINE_bool(accelerate, false, "whether to accelerate EM with SQUAREM");
+DEFINE_int32(block_size, 0, "documents per p(w|z) update of incremental EM, 0 means batch EM");
+DEFINE_int32(prune_after, 0, "iterations between prunings of p(w|z) to sparse topic lists, 0 means never");
+DEFINE_double(prune_tol, 1e-6, "p(w|z) entries below prune_tol are dropped by pruning");
+DEFINE_int32(lazy_interval, 0, "stable documents are revisited every lazy_interval iterations, 0 means every iteration");
+DEFINE_double(lazy_tol, 1e-3, "a document is stable when the L1 change of its p(z|d) is below lazy_tol");
+DEFINE_int32(shard_size, 0, "number of documents of each shard streamed from disk, 0 means in-core");
+DEFINE_string(swapdir, "../data/plsa/", "directory of the paged p(z|d) files in out-of-core mode");
+DEFINE_int32(min_df, 1, "drop words occurring in fewer documents");
+DEFINE_double(max_df, 1.0, "drop words occurring in more than this fraction of documents");
+DEFINE_int32(max_words, 0, "keep at most the max_words most frequent words, 0 means no limit");
+DEFINE_string(stopwords, "", "path of a stopword list whose words are dropped");
+DEFINE_string(heldout, "", "held-out documents whose perplexity is evaluated in the background during training");
+DEFINE_int32(eval_interval, 10, "iterations between held-out evaluations");
+DEFINE_bool(binary, false, "whether docpath is a binary corpus written by dataset_main, which needs dictpath as input");
+DEFINE_bool(pack, false, "whether to pack the documents and posting lists to save memory");
+
+template<typename Model>
+void Train(Model* plsa) {
+  VLOG(0) << "PLSA: " << plsa->ToString();
+
+  boost::posix_time::ptime start =
+      boost::posix_time::microsec_clock::local_time();
+  std::size_t niters = plsa->Train();
+  boost::posix_time::ptime end =
+      boost::posix_time::microsec_clock::local_time();
+  boost::posix_time::time_duration elapsed = end - start;
+  double duration_per_iter = static_cast<double>(elapsed.total_seconds()) / niters;
+  VLOG(0) << "niters=" << niters << ", duration_per_iter=" << duration_per_iter << "s";
+}
 
 int main(int argc, char **argv) {
   FLAGS_stderrthreshold = 0;
@@ -34,12 +65,55 @@ int main(int argc, char **argv) {
 
   VLOG(0) << "------" << argv[0] << "------";
 
+  if (FLAGS_shard_size > 0) {
+    CHECK(FLAGS_prune_after == 0 && FLAGS_lazy_interval == 0 && FLAGS_heldout.empty() &&
+        FLAGS_min_df <= 1 && FLAGS_max_df >= 1.0 && FLAGS_max_words == 0 && FLAGS_stopwords.empty() &&
+        !FLAGS_pack)
+        << "--prune_after, --lazy_interval, --heldout, --min_df, --max_df, --max_words, "
+        << "--stopwords and --pack are not supported with --shard_size";
+    toyml::StreamPLSAOptions options;
+    options.ntopics = FLAGS_topics;
+    options.niters = FLAGS_iterators;
+    options.eps = FLAGS_eps;
+    options.log_interval = FLAGS_log_interval;
+    options.save_interval = FLAGS_save_interval;
+    options.datadir = FLAGS_datadir;
+    options.random = FLAGS_random;
+    options.accelerate = FLAGS_accelerate;
+    options.block_size = FLAGS_block_size;
+    options.shard_size = FLAGS_shard_size;
+    options.swapdir = FLAGS_swapdir;
+    options.binary = FLAGS_binary;
+    options.dictpath = FLAGS_dictpath;
+    VLOG(0) << "options: " << options.ToString();
+
+    toyml::StreamPLSA plsa;
+    CHECK(plsa.Init(options, FLAGS_docpath)) << "Failed to scan file " << FLAGS_docpath;
+    if (!FLAGS_binary) {
+      CHECK(plsa.dataset().SaveDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
+    }
+    Train(&plsa);
+    return 0;
+  }
+
+  CHECK(!FLAGS_binary) << "--binary is only supported with --shard_size";
   toyml::DocumentSet dataset;
   CHECK(dataset.Load(FLAGS_docpath)) << "Failed to load file " << FLAGS_docpath;
   VLOG(0) << "docpath=" << FLAGS_docpath;
+  toyml::PruneOptions prune;
+  prune.min_df = FLAGS_min_df;
+  prune.max_df = FLAGS_max_df;
+  prune.max_words = FLAGS_max_words;
+  prune.stopwords = FLAGS_stopwords;
+  if (prune.Enabled()) {
+    CHECK(dataset.Prune(prune)) << "Failed to prune " << FLAGS_docpath;
+  }
   CHECK(dataset.SaveDetailedDict(FLAGS_dictpath)) << "Failed to save dictionary file " << FLAGS_dictpath;
-  VLOG(0) << "dataset.StatString: " << dataset.StatString();
-  VLOG(4) << "dataset.Doc(0): " << dataset.Doc(0).ToString();
+  if (FLAGS_pack) {
+    dataset.Pack();
+  }
+  VLOG(0) << "dataset.StatString: " << dataset.StatString() << ", EntryBytes=" << dataset.EntryBytes();
+  VLOG(4) << "dataset.DocString(0): " << dataset.DocString(0);
 
   toyml::PLSAOptions options;
   options.ntopics = FLAGS_topics;
@@ -49,20 +123,25 @@ int main(int argc, char **argv) {
   options.save_interval = FLAGS_save_interval;
   options.datadir = FLAGS_datadir;
   options.random = FLAGS_random;
+  options.accelerate = FLAGS_accelerate;
+  options.block_size = FLAGS_block_size;
+  options.prune_after = FLAGS_prune_after;
+  options.prune_tol = FLAGS_prune_tol;
+  options.lazy_interval = FLAGS_lazy_interval;
+  options.lazy_tol = FLAGS_lazy_tol;
   VLOG(0) << "options: " << options.ToString();
 
   toyml::PLSA plsa;
   CHECK(plsa.Init(options, dataset));
-  VLOG(0) << "PLSA: " << plsa.ToString();
-
-  boost::posix_time::ptime start =
-      boost::posix_time::microsec_clock::local_time();
-  std::size_t niters = plsa.Train();
-  boost::posix_time::ptime end =
-      boost::posix_time::microsec_clock::local_time();
-  boost::posix_time::time_duration elapsed = end - start;
-  double duration_per_iter = static_cast<double>(elapsed.total_seconds()) / niters;
-  VLOG(0) << "niters=" << niters << ", duration_per_iter=" << duration_per_iter << "s";
+  toyml::DocumentSet heldout;
+  toyml::HeldoutEvaluator evaluator;
+  if (!FLAGS_heldout.empty()) {
+    CHECK(heldout.Load(FLAGS_heldout)) << "Failed to load file " << FLAGS_heldout;
+    CHECK(evaluator.Init(toyml::HeldoutOptions(), dataset, heldout));
+    VLOG(0) << "HeldoutEvaluator: " << evaluator.ToString();
+    plsa.set_evaluator(&evaluator, FLAGS_eval_interval);
+  }
+  Train(&plsa);
 
   return 0;
 }
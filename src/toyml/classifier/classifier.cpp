@@ -24,6 +24,7 @@
  */
 
 #include "classifier.h"
+#include <glog/logging.h>
 
 namespace toyml {
 
@@ -33,4 +34,23 @@ Classifier::Classifier() {
 Classifier::~Classifier() {
 }
 
+std::size_t OnlineClassifier::StreamTrain(std::istream& is, std::size_t chunk_size,
+    LabelPosition label_pos) {
+  if (!is) return 0;
+  std::vector<Input> inputs;
+  std::vector<Output> labels;
+  std::size_t total = 0;
+  while (std::size_t n = ReadCsvChunk(is, chunk_size, &inputs, &labels, label_pos)) {
+    for (std::size_t i = 0; i < n; ++i) {
+      if (!OnlineTrain(inputs[i], labels[i])) {
+        LOG(ERROR) << "Failed to train row #" << total + i;
+        return total + i;
+      }
+    }
+    total += n;
+    VLOG(2) << "StreamTrain rows=" << total;
+  }
+  return total;
+}
+
 } /* namespace toyml */
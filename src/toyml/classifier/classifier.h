@@ -29,6 +29,7 @@
 #include <vector>
 
 #include <toyml/data/dataset.h>
+#include <toyml/data/csv.h>
 #include <toyml/model/model.h>
 
 namespace toyml {
@@ -51,7 +52,18 @@ public:
 
 class OnlineClassifier: public Classifier {
 public:
-  virtual bool OnlineTrain(const Input& inst) = 0;
+  // Updates the model with a single labeled instance
+  virtual bool OnlineTrain(const Input& input, Output label) = 0;
+
+  /**
+   * @brief Trains the model with one pass over labeled CSV rows of a stream
+   *
+   * Rows are parsed in chunks of chunk_size, so the memory does not depend on
+   * the size of the stream.
+   * @return the number of rows trained, or 0 if the stream is bad
+   */
+  std::size_t StreamTrain(std::istream& is, std::size_t chunk_size,
+      LabelPosition label_pos = LAST_COLUMN);
 };
 
 } /* namespace toyml */
@@ -24,13 +24,15 @@
  */
 
 #include "perceptron.h"
+#include <omp.h>
+#include <algorithm>
 #include <glog/logging.h>
 
 #include <toyml/util/util.h>
 
 namespace toyml {
 
-Perceptron::Perceptron(): b_(0) {
+Perceptron::Perceptron(): b_(0), ub_(0) {
 }
 
 Perceptron::~Perceptron() {
@@ -51,28 +53,270 @@ void Perceptron::Predict(const Input& input, Output* output) const {
   *output = (z >= 0);
 }
 
+void Perceptron::Predict(const SparseVector& input, Output* output) const {
+  double z = b_;
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    if (input.index(i) < w_.size()) {
+      z += w_(input.index(i)) * input.value(i);
+    }
+  }
+  *output = (z >= 0);
+}
+
+void Perceptron::Predict(const DenseVector& input, Output* output) const {
+  std::size_t n = std::min(input.size(), w_.size());
+  double z = b_;
+  for (std::size_t i = 0; i < n; ++i) {
+    z += w_(i) * input(i);
+  }
+  *output = (z >= 0);
+}
+
+void Perceptron::PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+    Outputs* outputs) const {
+  // GEMV of the block of inputs and w_, without a virtual call per input
+  const double* w = w_.size() > 0 ? &w_[0] : NULL;
+  for (std::size_t i = begin; i < end; ++i) {
+    const Input& input = inputs[i];
+    if (input.size() != w_.size()) {
+      Predict(input, &(*outputs)[i]);
+      continue;
+    }
+    const double* x = w != NULL ? &input[0] : NULL;
+    double z = b_;
+    for (std::size_t j = 0; j < w_.size(); ++j) {
+      z += w[j] * x[j];
+    }
+    (*outputs)[i] = (z >= 0);
+  }
+}
+
 bool Perceptron::Train(const ClassificationData& data) {
   VLOG(1) << "Train";
-  RealVector(data.dimension(), 0).swap(w_);
-  b_ = 0;
+  Reset(data.dimension());
+  std::size_t count = 1;
   for (std::size_t iter = 0; iter < opts_.niters; ++iter) {
     std::size_t err_cnt = 0;
-    for (std::size_t i = 0; i < data.num_instances(); ++i) {
+    for (std::size_t i = 0; i < data.num_instances(); ++i, ++count) {
       Output y = (*this)(data.input(i));
       if (y != data.label(i)) {
         ++err_cnt;
-        int sy = Sign(data.label(i));
-        w_ += opts_.learning_rate * sy * data.input(i);
-        b_ += opts_.learning_rate * sy;
+        double delta = opts_.learning_rate * Sign(data.label(i));
+        w_ += delta * data.input(i);
+        b_ += delta;
+        if (opts_.averaged) {
+          u_ += (count * delta) * data.input(i);
+          ub_ += count * delta;
+        }
 //        VLOG_EVERY_N(0, 500) << NV_(w_);
 //        VLOG_EVERY_N(0, 500) << NV_(data.input(i));
-//        VLOG_EVERY_N(0, 500) << NVC_(y) << NV_(sy);
       }
     }
     VLOG(2) << "iter#" << iter << ": " << NVC_(err_cnt) << NVC_(w_) << NV_(b_);
     if (err_cnt == 0) break;
   }
+  Average(count);
+  return true;
+}
+
+bool Perceptron::Train(const SparseClassificationData& data) {
+  VLOG(1) << "Train sparse data: " << data.ToString();
+  Reset(data.dimension());
+  if (data.dimension() == 0) return true;
+  std::size_t nthreads = opts_.mode == SERIAL ? 1 :
+      (opts_.threads ? opts_.threads : omp_get_max_threads());
+  std::size_t iter = 0;
+  while (iter < opts_.niters) {
+    std::size_t err_cnt = opts_.mode == PARAMETER_MIXING ?
+        MixingPass(data, iter, nthreads) : SharedPass(data, iter, nthreads);
+    VLOG(2) << "iter#" << iter << ": " << NVC_(err_cnt) << NV_(b_);
+    ++iter;
+    if (err_cnt == 0) break;
+  }
+  Average(iter * data.num_instances() + 1);
+  return true;
+}
+
+bool Perceptron::Train(const DenseClassificationData& data) {
+  VLOG(1) << "Train dense data: " << data.ToString();
+  std::size_t dimension = data.dimension();
+  Reset(dimension);
+  if (dimension == 0) return true;
+  double* w = &w_[0];
+  double* u = opts_.averaged ? &u_[0] : NULL;
+  std::size_t count = 1;
+  for (std::size_t iter = 0; iter < opts_.niters; ++iter) {
+    std::size_t err_cnt = 0;
+    for (std::size_t i = 0; i < data.num_instances(); ++i, ++count) {
+      const double* x = data.row(i);
+      double z = b_;
+      for (std::size_t j = 0; j < dimension; ++j) {
+        z += w[j] * x[j];
+      }
+      Output y = (z >= 0);
+      if (y != data.label(i)) {
+        ++err_cnt;
+        double delta = opts_.learning_rate * Sign(data.label(i));
+        for (std::size_t j = 0; j < dimension; ++j) {
+          w[j] += delta * x[j];
+        }
+        b_ += delta;
+        if (u != NULL) {
+          for (std::size_t j = 0; j < dimension; ++j) {
+            u[j] += count * delta * x[j];
+          }
+          ub_ += count * delta;
+        }
+      }
+    }
+    VLOG(2) << "iter#" << iter << ": " << NVC_(err_cnt) << NV_(b_);
+    if (err_cnt == 0) break;
+  }
+  Average(count);
   return true;
 }
 
+std::size_t Perceptron::SharedPass(const SparseClassificationData& data, std::size_t iter,
+    std::size_t nthreads) {
+  // With several threads, this is Hogwild: the updates of w_ and u_ are sparse
+  // and rarely collide, so they are done without any locking.
+  double* w = &w_[0];
+  double* u = opts_.averaged ? &u_[0] : NULL;
+  std::size_t n = data.num_instances();
+  std::size_t err_cnt = 0;
+#pragma omp parallel for num_threads(nthreads) schedule(static) reduction(+: err_cnt)
+  for (std::size_t i = 0; i < n; ++i) {
+    SparseVector x = data.input(i);
+    double z;
+#pragma omp atomic read
+    z = b_;
+    for (std::size_t k = 0; k < x.size(); ++k) {
+      z += w[x.index(k)] * x.value(k);
+    }
+    Output y = (z >= 0);
+    if (y != data.label(i)) {
+      ++err_cnt;
+      double delta = opts_.learning_rate * Sign(data.label(i));
+      for (std::size_t k = 0; k < x.size(); ++k) {
+        w[x.index(k)] += delta * x.value(k);
+      }
+#pragma omp atomic
+      b_ += delta;
+      if (u != NULL) {
+        double count = iter * n + i + 1;
+        for (std::size_t k = 0; k < x.size(); ++k) {
+          u[x.index(k)] += count * delta * x.value(k);
+        }
+#pragma omp atomic
+        ub_ += count * delta;
+      }
+    }
+  }
+  return err_cnt;
+}
+
+std::size_t Perceptron::MixingPass(const SparseClassificationData& data, std::size_t iter,
+    std::size_t nthreads) {
+  std::size_t dimension = w_.size();
+  std::size_t n = data.num_instances();
+  std::vector<RealVector> ws(nthreads);
+  std::vector<RealVector> us(nthreads);
+  std::vector<double> bs(nthreads, b_);
+  std::vector<double> ubs(nthreads, 0);
+  std::size_t err_cnt = 0;
+  // The runtime may start fewer threads than asked for
+  std::size_t nused = 0;
+#pragma omp parallel num_threads(nthreads) reduction(+: err_cnt)
+  {
+#pragma omp single
+    nused = omp_get_num_threads();
+    std::size_t tid = omp_get_thread_num();
+    ws[tid] = w_;
+    double* w = &ws[tid][0];
+    double* u = NULL;
+    if (opts_.averaged) {
+      RealVector(dimension, 0).swap(us[tid]);
+      u = &us[tid][0];
+    }
+    double& b = bs[tid];
+    double& ub = ubs[tid];
+#pragma omp for schedule(static)
+    for (std::size_t i = 0; i < n; ++i) {
+      SparseVector x = data.input(i);
+      double z = b;
+      for (std::size_t k = 0; k < x.size(); ++k) {
+        z += w[x.index(k)] * x.value(k);
+      }
+      Output y = (z >= 0);
+      if (y != data.label(i)) {
+        ++err_cnt;
+        double delta = opts_.learning_rate * Sign(data.label(i));
+        for (std::size_t k = 0; k < x.size(); ++k) {
+          w[x.index(k)] += delta * x.value(k);
+        }
+        b += delta;
+        if (u != NULL) {
+          double count = iter * n + i + 1;
+          for (std::size_t k = 0; k < x.size(); ++k) {
+            u[x.index(k)] += count * delta * x.value(k);
+          }
+          ub += count * delta;
+        }
+      }
+    }
+  }
+
+  // Uniform mixing, so the update of the mixed weights is the average of the
+  // updates of the threads
+  w_.clear();
+  b_ = 0;
+  for (std::size_t tid = 0; tid < nused; ++tid) {
+    w_ += ws[tid];
+    b_ += bs[tid];
+    if (opts_.averaged) {
+      u_ += us[tid] / nused;
+      ub_ += ubs[tid] / nused;
+    }
+  }
+  w_ /= nused;
+  b_ /= nused;
+  return err_cnt;
+}
+
+bool Perceptron::OnlineTrain(const Input& input, Output label) {
+  if (w_.size() == 0) {
+    RealVector(input.size(), 0).swap(w_);
+    b_ = 0;
+  }
+  if (input.size() != w_.size()) {
+    LOG(ERROR) << "input.size() != w_.size(). input.size=" << input.size()
+        << ", w_.size=" << w_.size();
+    return false;
+  }
+  if ((*this)(input) != label) {
+    double delta = opts_.learning_rate * Sign(label);
+    w_ += delta * input;
+    b_ += delta;
+  }
+  return true;
+}
+
+void Perceptron::Reset(std::size_t dimension) {
+  RealVector(dimension, 0).swap(w_);
+  b_ = 0;
+  if (opts_.averaged) {
+    RealVector(dimension, 0).swap(u_);
+  } else {
+    u_.resize(0);
+  }
+  ub_ = 0;
+}
+
+void Perceptron::Average(std::size_t count) {
+  if (!opts_.averaged) return;
+  w_ -= u_ / count;
+  b_ -= ub_ / count;
+  u_.resize(0);
+}
+
 } /* namespace toyml */
@@ -27,18 +27,29 @@
 #define PERCEPTRON_H_
 
 #include "classifier.h"
+#include <toyml/data/sparse_dataset.h>
+#include <toyml/data/dense_dataset.h>
 
 namespace toyml {
 
 /**
  * @brief 
  */
-class Perceptron: public Classifier {
+class Perceptron: public OnlineClassifier {
 public:
+  // How sparse data is trained with several threads
+  enum Mode {
+    SERIAL = 0,
+    HOGWILD,            // threads update the shared weights without locks
+    PARAMETER_MIXING    // threads train their own copies, which are averaged after each pass
+  };
   struct Options {
-    Options(): niters(100), learning_rate(0.01) {}
+    Options(): niters(100), learning_rate(0.01), averaged(false), mode(SERIAL), threads(0) {}
     std::size_t niters;
     double learning_rate;
+    bool averaged;  // whether to use the average of the weights over all updates
+    Mode mode;
+    std::size_t threads;  // 0 means all cores
   };
 
   Perceptron();
@@ -51,15 +62,40 @@ public:
   virtual std::string name() const { return "Perceptron"; }
 
   virtual void Predict(const Input& input, Output* output) const;
+  // Costs O(nnz), and features beyond the trained dimension are ignored
+  void Predict(const SparseVector& input, Output* output) const;
+  void Predict(const DenseVector& input, Output* output) const;
   using Classifier::Predict;
+  virtual void PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+      Outputs* outputs) const;
   virtual bool Train(const ClassificationData& data);
+  bool Train(const SparseClassificationData& data);
+  // Same updates as Train(ClassificationData), streaming the contiguous rows
+  bool Train(const DenseClassificationData& data);
+  // The first instance fixes the dimension of an untrained model. The weights
+  // are not averaged in online training.
+  virtual bool OnlineTrain(const Input& input, Output label);
+
+  const RealVector& weights() const { return w_; }
+  double bias() const { return b_; }
 private:
   Options opts_;
   RealVector w_;
   double b_;
+  // For the averaged perceptron, the sum of c * update over all updates where c
+  // counts the examples seen, so that the average weights are w_ - u_ / c
+  RealVector u_;
+  double ub_;
+
+  void Reset(std::size_t dimension);
+  void Average(std::size_t count);
+  // Each pass returns the number of mistakes
+  std::size_t SharedPass(const SparseClassificationData& data, std::size_t iter, std::size_t nthreads);
+  std::size_t MixingPass(const SparseClassificationData& data, std::size_t iter, std::size_t nthreads);
 
-  static int Sign(double x) {
-    return x >= 0 ? 1 : -1;
+  // maps label 1 to +1 and label 0 to -1
+  static int Sign(Output label) {
+    return label ? 1 : -1;
   }
 };
 } /* namespace toyml */
@@ -24,12 +24,185 @@
  */
 
 #include "perceptron.h"
+#include <fstream>
 #include <gtest/gtest.h>
 
 namespace toyml {
 
-TEST(Perceptron, Method) {
+namespace {
 
+const char* kData = "testdata/data/cls.csv";
+
+void ToSparse(const ClassificationData& data, SparseClassificationData* sparse) {
+  sparse->Clear();
+  std::vector<std::pair<uint32_t, double> > features;
+  for (std::size_t i = 0; i < data.num_instances(); ++i) {
+    features.clear();
+    for (std::size_t j = 0; j < data.dimension(); ++j) {
+      features.push_back(std::make_pair(static_cast<uint32_t>(j), data.input(i)(j)));
+    }
+    sparse->Add(features, data.label(i));
+  }
+}
+
+Perceptron::Options MakeOptions(bool averaged, Perceptron::Mode mode = Perceptron::SERIAL,
+    std::size_t threads = 0) {
+  Perceptron::Options options;
+  options.niters = 10;
+  options.averaged = averaged;
+  options.mode = mode;
+  options.threads = threads;
+  return options;
+}
+
+void ExpectSameModel(const Perceptron& expected, const Perceptron& actual, double tolerance) {
+  ASSERT_EQ(expected.weights().size(), actual.weights().size());
+  for (std::size_t j = 0; j < expected.weights().size(); ++j) {
+    EXPECT_NEAR(expected.weights()(j), actual.weights()(j), tolerance) << "j=" << j;
+  }
+  EXPECT_NEAR(expected.bias(), actual.bias(), tolerance);
+}
+
+}  // namespace
+
+class PerceptronTest: public testing::Test {
+protected:
+  virtual void SetUp() {
+    ASSERT_TRUE(ReadCsv(kData, &data_));
+    ASSERT_GT(data_.num_instances(), 0u);
+    ToSparse(data_, &sparse_);
+  }
+
+  ClassificationData data_;
+  SparseClassificationData sparse_;
+};
+
+TEST_F(PerceptronTest, SparseMatchesDense) {
+  for (int averaged = 0; averaged < 2; ++averaged) {
+    Perceptron expected, actual;
+    ASSERT_TRUE(expected.Init(MakeOptions(averaged)));
+    ASSERT_TRUE(actual.Init(MakeOptions(averaged)));
+    ASSERT_TRUE(expected.Train(data_));
+    ASSERT_TRUE(actual.Train(sparse_));
+    ExpectSameModel(expected, actual, 1e-12);
+  }
+}
+
+TEST_F(PerceptronTest, Averaged) {
+  // The average of the weights before the first example and after each example
+  Perceptron::Options options = MakeOptions(true);
+  std::size_t dimension = data_.dimension();
+  RealVector w(dimension, 0), sum_w(dimension, 0);
+  double b = 0, sum_b = 0;
+  std::size_t count = 1;
+  for (std::size_t iter = 0; iter < options.niters; ++iter) {
+    std::size_t err_cnt = 0;
+    for (std::size_t i = 0; i < data_.num_instances(); ++i, ++count) {
+      const RealVector& x = data_.input(i);
+      uint32_t y = (inner_prod(w, x) + b >= 0);
+      if (y != data_.label(i)) {
+        ++err_cnt;
+        double delta = options.learning_rate * (data_.label(i) ? 1 : -1);
+        w += delta * x;
+        b += delta;
+      }
+      sum_w += w;
+      sum_b += b;
+    }
+    if (err_cnt == 0) break;
+  }
+
+  Perceptron perceptron;
+  ASSERT_TRUE(perceptron.Init(options));
+  ASSERT_TRUE(perceptron.Train(data_));
+  for (std::size_t j = 0; j < dimension; ++j) {
+    EXPECT_NEAR(sum_w(j) / count, perceptron.weights()(j), 1e-9) << "j=" << j;
+  }
+  EXPECT_NEAR(sum_b / count, perceptron.bias(), 1e-9);
+
+  // and differs from the last weights of the plain perceptron
+  Perceptron plain;
+  ASSERT_TRUE(plain.Init(MakeOptions(false)));
+  ASSERT_TRUE(plain.Train(data_));
+  EXPECT_NE(plain.bias(), perceptron.bias());
+}
+
+TEST_F(PerceptronTest, OneThreadModesMatchSerial) {
+  Perceptron::Mode modes[] = {Perceptron::HOGWILD, Perceptron::PARAMETER_MIXING};
+  for (int averaged = 0; averaged < 2; ++averaged) {
+    Perceptron serial;
+    ASSERT_TRUE(serial.Init(MakeOptions(averaged)));
+    ASSERT_TRUE(serial.Train(sparse_));
+    for (std::size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+      SCOPED_TRACE(modes[m]);
+      Perceptron perceptron;
+      ASSERT_TRUE(perceptron.Init(MakeOptions(averaged, modes[m], 1)));
+      ASSERT_TRUE(perceptron.Train(sparse_));
+      // Parameter mixing sums the averaging terms pass by pass
+      ExpectSameModel(serial, perceptron, 1e-9);
+    }
+  }
+}
+
+TEST_F(PerceptronTest, TrainDenseData) {
+  DenseClassificationData dense;
+  ASSERT_TRUE(dense.Init(data_));
+  for (int averaged = 0; averaged < 2; ++averaged) {
+    Perceptron expected, actual;
+    ASSERT_TRUE(expected.Init(MakeOptions(averaged)));
+    ASSERT_TRUE(actual.Init(MakeOptions(averaged)));
+    ASSERT_TRUE(expected.Train(data_));
+    ASSERT_TRUE(actual.Train(dense));
+    ExpectSameModel(expected, actual, 1e-12);
+    for (std::size_t i = 0; i < data_.num_instances(); ++i) {
+      EXPECT_EQ(expected(data_.input(i)), actual(data_.input(i))) << "i=" << i;
+    }
+  }
+}
+
+TEST_F(PerceptronTest, StreamTrainMatchesTrain) {
+  const std::size_t chunk_sizes[] = {1, 7};
+  for (std::size_t npasses = 1; npasses <= 3; npasses += 2) {
+    Perceptron expected;
+    Perceptron::Options options = MakeOptions(false);
+    options.niters = npasses;
+    ASSERT_TRUE(expected.Init(options));
+    ASSERT_TRUE(expected.Train(data_));
+    for (std::size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++c) {
+      SCOPED_TRACE(chunk_sizes[c]);
+      Perceptron actual;
+      ASSERT_TRUE(actual.Init(options));
+      for (std::size_t pass = 0; pass < npasses; ++pass) {
+        std::ifstream inf(kData);
+        EXPECT_EQ(data_.num_instances(), actual.StreamTrain(inf, chunk_sizes[c]));
+      }
+      ExpectSameModel(expected, actual, 0);
+    }
+  }
+}
+
+TEST_F(PerceptronTest, PredictBlocks) {
+  Perceptron perceptron;
+  ASSERT_TRUE(perceptron.Init(MakeOptions(false)));
+  ASSERT_TRUE(perceptron.Train(data_));
+  // 7 does not divide the 1000 instances, so the last block is partial
+  ASSERT_NE(0u, data_.num_instances() % 7);
+  perceptron.set_predict_block_size(7);
+  perceptron.set_predict_threads(3);
+
+  ClassificationData::Outputs outputs;
+  perceptron.Predict(data_.inputs(), &outputs);
+  ASSERT_EQ(data_.num_instances(), outputs.size());
+  ClassificationData::Outputs block;
+  block.resize(data_.num_instances());
+  perceptron.PredictBlock(data_.inputs(), 3, 10, &block);
+  for (std::size_t i = 0; i < data_.num_instances(); ++i) {
+    Perceptron::Output expected = perceptron(data_.input(i));
+    EXPECT_EQ(expected, outputs[i]) << "i=" << i;
+    if (i >= 3 && i < 10) {
+      EXPECT_EQ(expected, block[i]) << "i=" << i;
+    }
+  }
 }
 
 } /* namespace toyml */
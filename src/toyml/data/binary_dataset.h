@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef TOYML_DATA_BINARY_DATASET_H_
+#define TOYML_DATA_BINARY_DATASET_H_
+
+#include <stdint.h>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <glog/logging.h>
+
+#include <toyml/common/common.h>
+#include <toyml/util/mapped_file.h>
+
+namespace toyml {
+
+enum BinaryLabelType {
+  BINARY_UINT32_LABELS = 0, BINARY_DOUBLE_LABELS
+};
+
+/**
+ * @brief Header of a binary dataset file, 64 bytes
+ *
+ * The header is followed by the label block, rows x label_dim labels of
+ * label_type, and the feature block, rows x dimension float or double values
+ * in row-major order, or dimension x rows when column_major. Both blocks start
+ * on 64-byte boundaries, so a mapped file is used in place.
+ */
+struct BinaryDatasetHeader {
+  char magic[8];          // "TOYMLDS"
+  uint32_t version;
+  uint32_t byte_order;    // kByteOrder as written by the writer
+  uint32_t label_type;    // BinaryLabelType
+  uint32_t label_dim;     // labels per instance
+  uint32_t value_size;    // 4 for float and 8 for double features
+  uint32_t column_major;
+  uint64_t rows;
+  uint64_t dimension;
+  char reserved[16];
+
+  static const uint32_t kVersion = 1;
+  static const uint32_t kByteOrder = 0x01020304;
+};
+
+/**
+ * @brief A binary dataset file mapped read-only, whose blocks are read in place
+ */
+class BinaryDataset {
+ public:
+  static const std::size_t kAlignment = 64;
+
+  BinaryDataset(): header_(NULL), labels_(NULL), features_(NULL) {}
+
+  bool Open(const std::string& path) {
+    header_ = NULL;
+    if (!file_.Open(path)) {
+      LOG(ERROR) << "Failed to open " << path;
+      return false;
+    }
+    const BinaryDatasetHeader* header = reinterpret_cast<const BinaryDatasetHeader*>(file_.data());
+    if (file_.size() < sizeof(BinaryDatasetHeader) ||
+        std::memcmp(header->magic, Magic(), sizeof(header->magic)) != 0) {
+      LOG(ERROR) << "Not a binary dataset: " << path;
+      return false;
+    }
+    if (header->version != BinaryDatasetHeader::kVersion ||
+        header->byte_order != BinaryDatasetHeader::kByteOrder) {
+      LOG(ERROR) << "Unsupported version " << header->version << " or byte order of " << path;
+      return false;
+    }
+    if ((header->value_size != sizeof(float) && header->value_size != sizeof(double)) ||
+        header->label_type > BINARY_DOUBLE_LABELS) {
+      LOG(ERROR) << "Invalid value_size " << header->value_size << " or label_type "
+          << header->label_type << " of " << path;
+      return false;
+    }
+    std::size_t labels_offset = RoundUp(sizeof(BinaryDatasetHeader));
+    std::size_t features_offset = labels_offset + RoundUp(LabelBytes(*header));
+    if (file_.size() < features_offset + header->rows * header->dimension * header->value_size) {
+      LOG(ERROR) << "Truncated binary dataset: " << path;
+      return false;
+    }
+    header_ = header;
+    labels_ = file_.data() + labels_offset;
+    features_ = file_.data() + features_offset;
+    return true;
+  }
+
+  std::size_t rows() const { return header_->rows; }
+  std::size_t dimension() const { return header_->dimension; }
+  std::size_t label_dim() const { return header_->label_dim; }
+  BinaryLabelType label_type() const { return static_cast<BinaryLabelType>(header_->label_type); }
+  std::size_t value_size() const { return header_->value_size; }
+  bool column_major() const { return header_->column_major != 0; }
+
+  // The label blocks, NULL if the labels are of the other type
+  const uint32_t* uint32_labels() const {
+    return label_type() == BINARY_UINT32_LABELS ? reinterpret_cast<const uint32_t*>(labels_) : NULL;
+  }
+  const double* double_labels() const {
+    return label_type() == BINARY_DOUBLE_LABELS ? reinterpret_cast<const double*>(labels_) : NULL;
+  }
+  // Label k of instance i of either type
+  double label(std::size_t i, std::size_t k = 0) const {
+    std::size_t index = i * label_dim() + k;
+    return label_type() == BINARY_UINT32_LABELS ? uint32_labels()[index] : double_labels()[index];
+  }
+
+  // The feature block as T, NULL if the values are not of type T
+  template<typename T>
+  const T* features() const {
+    return value_size() == sizeof(T) ? reinterpret_cast<const T*>(features_) : NULL;
+  }
+  // Feature j of instance i of either type and layout
+  double feature(std::size_t i, std::size_t j) const {
+    std::size_t index = column_major() ? j * rows() + i : i * dimension() + j;
+    return value_size() == sizeof(double) ? features<double>()[index] : features<float>()[index];
+  }
+
+  static std::size_t RoundUp(std::size_t n) {
+    return (n + kAlignment - 1) / kAlignment * kAlignment;
+  }
+  static std::size_t LabelBytes(const BinaryDatasetHeader& header) {
+    return header.rows * header.label_dim *
+        (header.label_type == BINARY_UINT32_LABELS ? sizeof(uint32_t) : sizeof(double));
+  }
+
+  // "TOYMLDS" and its terminating null fill BinaryDatasetHeader::magic
+  static const char* Magic() { return "TOYMLDS"; }
+ private:
+  MappedFile file_;
+  const BinaryDatasetHeader* header_;
+  const char* labels_;
+  const char* features_;
+};
+
+namespace binary_internal {
+
+inline BinaryLabelType LabelType(uint32_t) { return BINARY_UINT32_LABELS; }
+inline BinaryLabelType LabelType(double) { return BINARY_DOUBLE_LABELS; }
+inline BinaryLabelType LabelType(const RealVector&) { return BINARY_DOUBLE_LABELS; }
+
+inline std::size_t LabelDim(uint32_t) { return 1; }
+inline std::size_t LabelDim(double) { return 1; }
+inline std::size_t LabelDim(const RealVector& label) { return label.size(); }
+
+// Appends the label to the block of its type
+inline void PutLabel(uint32_t label, std::vector<uint32_t>* uint32_labels, std::vector<double>*) {
+  uint32_labels->push_back(label);
+}
+inline void PutLabel(double label, std::vector<uint32_t>*, std::vector<double>* double_labels) {
+  double_labels->push_back(label);
+}
+inline void PutLabel(const RealVector& label, std::vector<uint32_t>*, std::vector<double>* double_labels) {
+  double_labels->insert(double_labels->end(), label.begin(), label.end());
+}
+
+inline void GetLabel(const BinaryDataset& dataset, std::size_t i, uint32_t* label) {
+  *label = static_cast<uint32_t>(dataset.label(i));
+}
+inline void GetLabel(const BinaryDataset& dataset, std::size_t i, double* label) {
+  *label = dataset.label(i);
+}
+inline void GetLabel(const BinaryDataset& dataset, std::size_t i, RealVector* label) {
+  label->resize(dataset.label_dim(), false);
+  for (std::size_t k = 0; k < dataset.label_dim(); ++k) {
+    (*label)(k) = dataset.label(i, k);
+  }
+}
+
+inline bool WritePadded(std::ofstream& outf, const void* data, std::size_t bytes) {
+  static const char kZeros[BinaryDataset::kAlignment] = {0};
+  if (bytes > 0) outf.write(static_cast<const char*>(data), bytes);
+  outf.write(kZeros, BinaryDataset::RoundUp(bytes) - bytes);
+  return outf.good();
+}
+
+}  // namespace binary_internal
+
+/**
+ * @brief Writes labeled data as a binary dataset with Value (float or double) features
+ *
+ * All inputs must have the same size, and vector labels the same size.
+ */
+template<typename Value, typename LabeledData>
+bool WriteBinaryDataset(const std::string& path, const LabeledData& data, bool column_major = false) {
+  typedef typename LabeledData::Label Label;
+  std::size_t rows = data.size();
+  std::size_t dimension = rows > 0 ? data.input(0).size() : 0;
+  Label first = rows > 0 ? data.label(0) : Label();
+  std::size_t label_dim = rows > 0 ? binary_internal::LabelDim(first) : 1;
+
+  BinaryDatasetHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, BinaryDataset::Magic(), sizeof(header.magic));
+  header.version = BinaryDatasetHeader::kVersion;
+  header.byte_order = BinaryDatasetHeader::kByteOrder;
+  header.label_type = binary_internal::LabelType(first);
+  header.label_dim = label_dim;
+  header.value_size = sizeof(Value);
+  header.column_major = column_major;
+  header.rows = rows;
+  header.dimension = dimension;
+
+  std::vector<uint32_t> uint32_labels;
+  std::vector<double> double_labels;
+  std::vector<Value> features(rows * dimension);
+  for (std::size_t i = 0; i < rows; ++i) {
+    if (data.input(i).size() != dimension || binary_internal::LabelDim(data.label(i)) != label_dim) {
+      LOG(ERROR) << "Instance#" << i << " differs in size from the first one";
+      return false;
+    }
+    binary_internal::PutLabel(data.label(i), &uint32_labels, &double_labels);
+    for (std::size_t j = 0; j < dimension; ++j) {
+      features[column_major ? j * rows + i : i * dimension + j] = data.input(i)(j);
+    }
+  }
+
+  std::ofstream outf(path.c_str(), std::ios::binary);
+  if (!outf) {
+    LOG(ERROR) << "Failed to open " << path;
+    return false;
+  }
+  bool ret = binary_internal::WritePadded(outf, &header, sizeof(header));
+  if (header.label_type == BINARY_UINT32_LABELS) {
+    ret = ret && binary_internal::WritePadded(outf, uint32_labels.empty() ? NULL : &uint32_labels[0],
+        uint32_labels.size() * sizeof(uint32_t));
+  } else {
+    ret = ret && binary_internal::WritePadded(outf, double_labels.empty() ? NULL : &double_labels[0],
+        double_labels.size() * sizeof(double));
+  }
+  if (!features.empty()) {
+    outf.write(reinterpret_cast<const char*>(&features[0]), features.size() * sizeof(Value));
+  }
+  ret = ret && outf.good();
+  if (!ret) LOG(ERROR) << "Failed to write " << path;
+  return ret;
+}
+
+/**
+ * @brief Reads a binary dataset into the containers of labeled data
+ */
+template<typename LabeledData>
+bool ReadBinaryDataset(const std::string& path, LabeledData* data) {
+  BinaryDataset dataset;
+  if (!dataset.Open(path)) return false;
+  typename LabeledData::Inputs inputs;
+  typename LabeledData::Labels labels;
+  inputs.resize(dataset.rows());
+  labels.resize(dataset.rows());
+  const double* features = dataset.column_major() ? NULL : dataset.features<double>();
+  for (std::size_t i = 0; i < dataset.rows(); ++i) {
+    typename LabeledData::Input& input = inputs[i];
+    input.resize(dataset.dimension(), false);
+    if (features != NULL) {
+      std::copy(features + i * dataset.dimension(), features + (i + 1) * dataset.dimension(),
+          input.begin());
+    } else {
+      for (std::size_t j = 0; j < dataset.dimension(); ++j) {
+        input(j) = dataset.feature(i, j);
+      }
+    }
+    binary_internal::GetLabel(dataset, i, &labels[i]);
+  }
+  return data->Swap(inputs, labels);
+}
+
+} /* namespace toyml */
+#endif /* TOYML_DATA_BINARY_DATASET_H_ */
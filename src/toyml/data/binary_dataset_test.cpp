@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "binary_dataset.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include "csv.h"
+
+namespace toyml {
+
+TEST(BinaryDataset, ClassificationData) {
+  ClassificationData expected;
+  ASSERT_TRUE(ReadCsv("testdata/data/cls.csv", &expected));
+  const std::string path = "binary_dataset_test.bin";
+  ASSERT_TRUE(expected.Write(path));
+
+  ClassificationData actual;
+  ASSERT_TRUE(actual.Read(path));
+  ASSERT_EQ(expected.size(), actual.size());
+  EXPECT_EQ(expected.num_classes(), actual.num_classes());
+  EXPECT_EQ(expected.labels(), actual.labels());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    for (std::size_t j = 0; j < expected.dimension(); ++j) {
+      EXPECT_EQ(expected.input(i)(j), actual.input(i)(j));
+    }
+  }
+
+  BinaryDataset dataset;
+  ASSERT_TRUE(dataset.Open(path));
+  EXPECT_EQ(expected.size(), dataset.rows());
+  EXPECT_EQ(expected.dimension(), dataset.dimension());
+  EXPECT_EQ(BINARY_UINT32_LABELS, dataset.label_type());
+  ASSERT_TRUE(dataset.uint32_labels() != NULL);
+  EXPECT_EQ(expected.label(1), dataset.uint32_labels()[1]);
+  ASSERT_TRUE(dataset.features<double>() != NULL);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(dataset.features<double>()) % BinaryDataset::kAlignment);
+  EXPECT_EQ(expected.input(3)(1), dataset.features<double>()[3 * dataset.dimension() + 1]);
+
+  // float features in column-major order
+  ASSERT_TRUE(WriteBinaryDataset<float>(path, expected, true));
+  ASSERT_TRUE(dataset.Open(path));
+  EXPECT_TRUE(dataset.column_major());
+  ASSERT_TRUE(dataset.features<double>() == NULL);
+  ASSERT_TRUE(dataset.features<float>() != NULL);
+  EXPECT_EQ(static_cast<float>(expected.input(3)(1)), dataset.features<float>()[dataset.rows() + 3]);
+  EXPECT_EQ(static_cast<float>(expected.input(3)(1)), dataset.feature(3, 1));
+  std::remove(path.c_str());
+
+  EXPECT_FALSE(actual.Read("testdata/data/cls.csv"));
+  EXPECT_FALSE(actual.Read("null/null"));
+}
+
+TEST(BinaryDataset, RegressionData) {
+  std::vector<RealVector> inputs(3, RealVector(2, 1.5));
+  std::vector<RealVector> targets(3, RealVector(4, -2));
+  targets[2](3) = 7;
+  RegressionData expected;
+  ASSERT_TRUE(expected.Init(inputs, targets));
+  const std::string path = "binary_dataset_test.bin";
+  ASSERT_TRUE(expected.Write(path));
+
+  RegressionData actual;
+  ASSERT_TRUE(actual.Read(path));
+  ASSERT_EQ(3U, actual.size());
+  EXPECT_EQ(2U, actual.dimension());
+  ASSERT_EQ(4U, actual.label(2).size());
+  EXPECT_DOUBLE_EQ(7, actual.label(2)(3));
+  EXPECT_DOUBLE_EQ(-2, actual.label(0)(0));
+  EXPECT_DOUBLE_EQ(1.5, actual.input(1)(1));
+  std::remove(path.c_str());
+}
+
+} /* namespace toyml */
@@ -26,14 +26,21 @@
 #ifndef CSV_H_
 #define CSV_H_
 
+#include <omp.h>
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <glog/logging.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include "util.h"
 #include "dataset.h"
+#include "dense_dataset.h"
+#include <toyml/util/mapped_file.h>
 
 namespace toyml {
 
@@ -43,8 +50,8 @@ enum LabelPosition {
   FIRST_COLUMN = 0, LAST_COLUMN
 };
 
-const char* kCsvDefaultSerparator = "\t, ";
-const char* kCsvDefaultComment = "#";
+const char* const kCsvDefaultSerparator = "\t, ";
+const char* const kCsvDefaultComment = "#";
 
 template<typename C>
 bool ReadCsv(std::istream& is, C* data, const std::string &separator =
@@ -72,6 +79,45 @@ bool ReadCsv(std::istream& is, C* data, const std::string &separator =
   return true;
 }
 
+/**
+ * @brief Parses a line of labeled data, returns false if it should be skipped
+ *
+ * toks is a buffer of tokens that can be reused across lines
+ */
+template<typename Input, typename Label>
+bool ParseCsvLine(std::string& line, std::vector<std::string>& toks,
+    Input* input, Label* label, LabelPosition label_pos,
+    const std::string& separator, const std::string& comment) {
+  typedef typename Input::value_type Value;
+
+  if (line.empty() || (!comment.empty() && line.find(comment) == 0)) return false;
+  bool first_column = (label_pos == FIRST_COLUMN);
+  algo::trim(line);
+  algo::split(toks, line, algo::is_any_of(separator));
+  if (toks.size() < 2) {
+    LOG(WARNING)<< "toks.size() is too small. toks.size=" << toks.size()
+    << ", line=" << line;
+    return false;
+  }
+  try {
+    *label = boost::lexical_cast<Value>(first_column ?
+        toks.front() : toks.back());
+  } catch (const boost::bad_lexical_cast& e) {
+  }
+  Input(toks.size() - 1, 0).swap(*input);
+  std::size_t begin = first_column;
+  std::size_t end = toks.size() - (!first_column);
+  for (std::size_t i = begin; i < end; ++i) {
+    Value v;
+    try {
+      v = boost::lexical_cast<Value>(toks[i]);
+    } catch (const boost::bad_lexical_cast& e) {
+    }
+    (*input)(i - begin) = v;
+  }
+  return true;
+}
+
 template<typename Labels, typename Inputs>
 bool ReadCsv(std::istream& is, Inputs* inputs, Labels* labels,
     LabelPosition label_pos = LAST_COLUMN, const std::string& separator =
@@ -79,45 +125,48 @@ bool ReadCsv(std::istream& is, Inputs* inputs, Labels* labels,
     const std::string &comment = kCsvDefaultComment) {
   typedef typename Labels::value_type Label;
   typedef typename Inputs::value_type Input;
-  typedef typename Input::value_type Value;
 
   if (!is) return false;
 
-  bool first_column = (label_pos == FIRST_COLUMN);
   std::string line;
   std::vector<std::string> toks;
+  Label label;
+  Input input;
   while (std::getline(is, line)) {
-    if (line.empty() || (!comment.empty() && line.find(comment) == 0)) continue;
-    algo::trim(line);
-    algo::split(toks, line, algo::is_any_of(separator));
-    if (toks.size() < 2) {
-      LOG(WARNING)<< "toks.size() is too small. toks.size=" << toks.size()
-      << ", line=" << line;
-      continue;
-    }
-    Label label;
-    try {
-      label = boost::lexical_cast<Value>(first_column ?
-          toks.front() : toks.back());
-    } catch (const boost::bad_lexical_cast& e) {
-    }
-    Input input(toks.size() - 1, 0);
-    std::size_t begin = first_column;
-    std::size_t end = toks.size() - (!first_column);
-    for (std::size_t i = begin; i < end; ++i) {
-      Value v;
-      try {
-        v = boost::lexical_cast<Value>(toks[i]);
-      } catch (const boost::bad_lexical_cast& e) {
-      }
-      input(i - begin) = v;
-    }
+    if (!ParseCsvLine(line, toks, &input, &label, label_pos, separator, comment)) continue;
     labels->push_back(label);
     inputs->push_back(input);
   }
   return true;
 }
 
+/**
+ * @brief Reads at most max_rows rows of labeled data into inputs and labels
+ *
+ * The containers are resized to the number of rows read, so the rows of the
+ * previous chunk are reused and the memory is bounded by max_rows.
+ * @return the number of rows read, 0 at the end of the stream
+ */
+template<typename Labels, typename Inputs>
+std::size_t ReadCsvChunk(std::istream& is, std::size_t max_rows, Inputs* inputs, Labels* labels,
+    LabelPosition label_pos = LAST_COLUMN, const std::string& separator =
+        kCsvDefaultSerparator,
+    const std::string &comment = kCsvDefaultComment) {
+  inputs->resize(max_rows);
+  labels->resize(max_rows);
+  std::size_t n = 0;
+  std::string line;
+  std::vector<std::string> toks;
+  while (n < max_rows && std::getline(is, line)) {
+    if (ParseCsvLine(line, toks, &(*inputs)[n], &(*labels)[n], label_pos, separator, comment)) {
+      ++n;
+    }
+  }
+  inputs->resize(n);
+  labels->resize(n);
+  return n;
+}
+
 template<typename LabeledData>
 bool ReadCsv(const std::string& path, LabeledData* data,
     LabelPosition label_pos = LAST_COLUMN, const std::string& separator =
@@ -135,5 +184,287 @@ bool ReadCsv(const std::string& path, LabeledData* data,
   return ret;
 }
 
+namespace csv_internal {
+
+inline double ParseDoubleSlow(const char* begin, const char* end) {
+  std::string tok(begin, end);
+  char* stop = NULL;
+  double v = std::strtod(tok.c_str(), &stop);
+  return !tok.empty() && stop == tok.c_str() + tok.size() ? v : 0;
+}
+
+/**
+ * @brief Parses the number in [begin, end), 0 if it is not a number
+ *
+ * Decimals whose significand fits in 53 bits and whose exponent is at most
+ * 22 in magnitude are converted with one exact multiplication or division,
+ * which rounds correctly; everything else goes through strtod.
+ */
+inline double ParseDouble(const char* begin, const char* end) {
+  static const double kPowersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const char* p = begin;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  uint64_t significand = 0;
+  int digits = 0;  // significant digits in significand
+  int exponent = 0;
+  bool any = false;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+    any = true;
+    if (digits < 19) {
+      significand = significand * 10 + (*p - '0');
+      digits += significand > 0;
+    } else {
+      ++exponent;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+      any = true;
+      if (digits < 19) {
+        significand = significand * 10 + (*p - '0');
+        digits += significand > 0;
+        --exponent;
+      }
+    }
+  }
+  if (!any) return ParseDoubleSlow(begin, end);
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negative_exponent = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative_exponent = (*p == '-');
+      ++p;
+    }
+    if (p == end) return ParseDoubleSlow(begin, end);
+    int e = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+      if (e < 100000) e = e * 10 + (*p - '0');
+    }
+    exponent += negative_exponent ? -e : e;
+  }
+  if (p != end) return ParseDoubleSlow(begin, end);
+  if (significand == 0) return negative ? -0.0 : 0.0;
+  if (significand > (1ULL << 53) || exponent < -22 || exponent > 22) {
+    return ParseDoubleSlow(begin, end);
+  }
+  double v = static_cast<double>(significand);
+  v = exponent < 0 ? v / kPowersOf10[-exponent] : v * kPowersOf10[exponent];
+  return negative ? -v : v;
+}
+
+inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Trims the line [*begin, *end) and counts its fields as ParseCsvLine splits them
+ *
+ * @return 0 for empty and comment lines
+ */
+inline std::size_t CountFields(const char** begin, const char** end, const bool* is_separator,
+    const std::string& comment) {
+  const char* b = *begin;
+  const char* e = *end;
+  if (b == e) return 0;
+  if (!comment.empty() && static_cast<std::size_t>(e - b) >= comment.size() &&
+      std::memcmp(b, comment.data(), comment.size()) == 0) {
+    return 0;
+  }
+  while (b < e && IsSpace(*b)) ++b;
+  while (e > b && IsSpace(e[-1])) --e;
+  std::size_t fields = 1;
+  for (const char* p = b; p < e; ++p) {
+    fields += is_separator[static_cast<unsigned char>(*p)];
+  }
+  *begin = b;
+  *end = e;
+  return fields;
+}
+
+/**
+ * @brief The parallel scan behind ReadCsvFast and ReadCsvDense
+ *
+ * The file is memory-mapped and cut into one chunk of lines per thread. A
+ * first pass counts the rows and the largest number of fields of every
+ * chunk, then sink->Resize(rows, dimension) allocates everything once and
+ * each chunk fills its own rows: sink->Row(row, n) returns room for the n
+ * inputs of the row and sink->SetLabel(row, v) stores the label.
+ */
+template<typename Sink>
+bool ScanCsv(const std::string& path, Sink* sink, LabelPosition label_pos,
+    const std::string& separator, const std::string& comment, std::size_t threads) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    LOG(ERROR) << "Failed to open " << path;
+    return false;
+  }
+  bool is_separator[256] = {false};
+  for (std::size_t i = 0; i < separator.size(); ++i) {
+    is_separator[static_cast<unsigned char>(separator[i])] = true;
+  }
+  const char* text = file.data();
+  std::size_t size = file.size();
+
+  // chunk c holds the lines starting in [bounds[c], bounds[c + 1])
+  std::size_t nchunks = threads ? threads : omp_get_max_threads();
+  std::vector<const char*> bounds(nchunks + 1, text + size);
+  bounds[0] = text;
+  for (std::size_t c = 1; c < nchunks; ++c) {
+    std::size_t pos = c * size / nchunks;
+    const char* b = text + pos;
+    if (pos > 0) {
+      const void* eol = std::memchr(text + pos - 1, '\n', size - pos + 1);
+      b = eol ? static_cast<const char*>(eol) + 1 : text + size;
+    }
+    bounds[c] = std::max(b, bounds[c - 1]);
+  }
+
+  std::vector<std::size_t> offsets(nchunks + 1, 0);
+  std::vector<std::size_t> max_fields(nchunks, 0);
+#pragma omp parallel for schedule(static, 1) num_threads(nchunks)
+  for (std::size_t c = 0; c < nchunks; ++c) {
+    std::size_t rows = 0;
+    for (const char* p = bounds[c]; p < bounds[c + 1]; ) {
+      const char* eol = static_cast<const char*>(std::memchr(p, '\n', bounds[c + 1] - p));
+      const char* b = p;
+      const char* e = eol ? eol : bounds[c + 1];
+      p = e + 1;
+      std::size_t fields = CountFields(&b, &e, is_separator, comment);
+      if (fields == 1) {
+        LOG(WARNING) << "Too few fields, line=" << std::string(b, e);
+      }
+      if (fields >= 2) {
+        ++rows;
+        max_fields[c] = std::max(max_fields[c], fields);
+      }
+    }
+    offsets[c + 1] = rows;
+  }
+  std::size_t dimension = 0;
+  for (std::size_t c = 0; c < nchunks; ++c) {
+    offsets[c + 1] += offsets[c];
+    dimension = std::max(dimension, max_fields[c] > 0 ? max_fields[c] - 1 : 0);
+  }
+
+  sink->Resize(offsets[nchunks], dimension);
+  bool first_column = (label_pos == FIRST_COLUMN);
+#pragma omp parallel for schedule(static, 1) num_threads(nchunks)
+  for (std::size_t c = 0; c < nchunks; ++c) {
+    std::size_t row = offsets[c];
+    for (const char* p = bounds[c]; p < bounds[c + 1]; ) {
+      const char* eol = static_cast<const char*>(std::memchr(p, '\n', bounds[c + 1] - p));
+      const char* b = p;
+      const char* e = eol ? eol : bounds[c + 1];
+      p = e + 1;
+      std::size_t fields = CountFields(&b, &e, is_separator, comment);
+      if (fields < 2) continue;
+
+      double* input = sink->Row(row, fields - 1);
+      std::size_t label_field = first_column ? 0 : fields - 1;
+      const char* f = b;
+      for (std::size_t i = 0; i < fields; ++i) {
+        const char* fe = f;
+        while (fe < e && !is_separator[static_cast<unsigned char>(*fe)]) ++fe;
+        double v = ParseDouble(f, fe);
+        if (i == label_field) {
+          sink->SetLabel(row, v);
+        } else {
+          input[i - first_column] = v;
+        }
+        f = fe + 1;
+      }
+      ++row;
+    }
+  }
+  return true;
+}
+
+// Fills the containers of LabeledData, one input vector per row
+template<typename LabeledData>
+class LabeledDataSink {
+public:
+  typedef typename LabeledData::Input Input;
+  typedef typename LabeledData::Label Label;
+
+  void Resize(std::size_t rows, std::size_t dimension) {
+    inputs.resize(rows);
+    labels.resize(rows);
+  }
+  double* Row(std::size_t row, std::size_t n) {
+    Input(n).swap(inputs[row]);
+    return &inputs[row][0];
+  }
+  void SetLabel(std::size_t row, double v) {
+    labels[row] = static_cast<Label>(v);
+  }
+
+  typename LabeledData::Inputs inputs;
+  typename LabeledData::Labels labels;
+};
+
+// Fills the row-major buffer of DenseLabeledData in place
+template<typename DenseData>
+class DenseDataSink {
+public:
+  explicit DenseDataSink(DenseData* data): data_(data) {}
+
+  void Resize(std::size_t rows, std::size_t dimension) {
+    data_->Resize(rows, dimension);
+  }
+  double* Row(std::size_t row, std::size_t n) {
+    return data_->mutable_row(row);
+  }
+  void SetLabel(std::size_t row, double v) {
+    data_->label(row) = static_cast<typename DenseData::Label>(v);
+  }
+private:
+  DenseData* data_;
+};
+
+}  // namespace csv_internal
+
+/**
+ * @brief Reads labeled data from the file path like ReadCsv, but much faster
+ *
+ * See csv_internal::ScanCsv: the rows are counted first, so the inputs and
+ * labels are allocated once, chunks of lines are parsed in parallel and
+ * numbers are parsed in place by csv_internal::ParseDouble. Lines are
+ * skipped by the same rules as ParseCsvLine, and unparsable fields are 0.
+ * @param threads the number of threads, 0 means all cores
+ */
+template<typename LabeledData>
+bool ReadCsvFast(const std::string& path, LabeledData* data,
+    LabelPosition label_pos = LAST_COLUMN, const std::string& separator =
+        kCsvDefaultSerparator,
+    const std::string& comment = kCsvDefaultComment, std::size_t threads = 0) {
+  csv_internal::LabeledDataSink<LabeledData> sink;
+  if (!csv_internal::ScanCsv(path, &sink, label_pos, separator, comment, threads)) {
+    return false;
+  }
+  return data->Swap(sink.inputs, sink.labels);
+}
+
+/**
+ * @brief ReadCsvFast into the contiguous rows of a DenseLabeledData
+ *
+ * The dimension is the largest number of inputs of a row; shorter rows are
+ * padded with 0.
+ */
+template<typename DenseData>
+bool ReadCsvDense(const std::string& path, DenseData* data,
+    LabelPosition label_pos = LAST_COLUMN, const std::string& separator =
+        kCsvDefaultSerparator,
+    const std::string& comment = kCsvDefaultComment, std::size_t threads = 0) {
+  csv_internal::DenseDataSink<DenseData> sink(data);
+  return csv_internal::ScanCsv(path, &sink, label_pos, separator, comment, threads);
+}
+
 } /* namespace toyml */
 #endif /* CSV_H_ */
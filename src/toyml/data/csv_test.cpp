@@ -55,4 +55,77 @@ TEST(Csv, ReadCsv) {
   EXPECT_DOUBLE_EQ(0, data2.input(0)(1));
 }
 
+TEST(Csv, ReadCsvChunk) {
+  std::ifstream inf("testdata/data/cls.10.csv");
+  ASSERT_TRUE(inf);
+  std::vector<RealVector> inputs;
+  std::vector<uint32_t> labels;
+  EXPECT_EQ(4U, ReadCsvChunk(inf, 4, &inputs, &labels));
+  EXPECT_EQ(4U, inputs.size());
+  EXPECT_EQ(0U, labels[0]);
+  EXPECT_DOUBLE_EQ(2.4114, inputs[0](0));
+  EXPECT_EQ(4U, ReadCsvChunk(inf, 4, &inputs, &labels));
+  EXPECT_EQ(2U, ReadCsvChunk(inf, 4, &inputs, &labels));
+  EXPECT_EQ(2U, inputs.size());
+  EXPECT_EQ(1U, labels[1]);
+  EXPECT_EQ(0U, ReadCsvChunk(inf, 4, &inputs, &labels));
+}
+
+TEST(Csv, ReadCsvFast) {
+  ClassificationData data;
+  EXPECT_FALSE(ReadCsvFast("null/null", &data));
+  for (std::size_t threads = 1; threads <= 4; ++threads) {
+    ClassificationData expected, actual;
+    ASSERT_TRUE(ReadCsv("testdata/data/cls.csv", &expected));
+    ASSERT_TRUE(ReadCsvFast("testdata/data/cls.csv", &actual, LAST_COLUMN,
+        kCsvDefaultSerparator, kCsvDefaultComment, threads));
+    ASSERT_EQ(expected.size(), actual.size());
+    EXPECT_EQ(expected.num_classes(), actual.num_classes());
+    EXPECT_EQ(expected.labels(), actual.labels());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(expected.input(i).size(), actual.input(i).size());
+      for (std::size_t j = 0; j < expected.input(i).size(); ++j) {
+        EXPECT_EQ(expected.input(i)(j), actual.input(i)(j));
+      }
+    }
+  }
+
+  LabeledData<RealVector, double> data2;
+  ASSERT_TRUE(ReadCsvFast("testdata/data/cls.10.csv", &data2, FIRST_COLUMN));
+  EXPECT_EQ(10U, data2.size());
+  EXPECT_DOUBLE_EQ(2.4114, data2.label(0));
+  EXPECT_EQ(2U, data2.input(0).size());
+  EXPECT_DOUBLE_EQ(-3.8901, data2.input(0)(0));
+  EXPECT_DOUBLE_EQ(0, data2.input(0)(1));
+}
+
+TEST(Csv, ReadCsvDense) {
+  ClassificationData expected;
+  DenseClassificationData actual;
+  EXPECT_FALSE(ReadCsvDense("null/null", &actual));
+  ASSERT_TRUE(ReadCsv("testdata/data/cls.csv", &expected));
+  ASSERT_TRUE(ReadCsvDense("testdata/data/cls.csv", &actual));
+  ASSERT_EQ(expected.size(), actual.size());
+  ASSERT_EQ(expected.dimension(), actual.dimension());
+  EXPECT_EQ(expected.num_classes(), actual.num_classes());
+  EXPECT_EQ(expected.labels(), actual.labels());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    for (std::size_t j = 0; j < expected.dimension(); ++j) {
+      EXPECT_EQ(expected.input(i)(j), actual.input(i)(j));
+    }
+  }
+}
+
+TEST(Csv, ParseDouble) {
+  const char* const toks[] = {"0", "-0.5", "+12.25", "3.8901e-3", "1E5", "123456789012345678901",
+      "1e-300", ".5", "7.", "abc", "", "1e", "nan0"};
+  for (std::size_t i = 0; i < sizeof(toks) / sizeof(toks[0]); ++i) {
+    const char* tok = toks[i];
+    char* stop = NULL;
+    double expected = std::strtod(tok, &stop);
+    if (*tok == '\0' || *stop != '\0') expected = 0;
+    EXPECT_EQ(expected, csv_internal::ParseDouble(tok, tok + std::strlen(tok))) << tok;
+  }
+}
+
 } /* namespace toyml */
@@ -39,6 +39,7 @@
 
 #include <toyml/common/common.h>
 #include <toyml/data/util.h>
+#include <toyml/data/binary_dataset.h>
 
 namespace toyml {
 
@@ -101,17 +102,21 @@ public:
   std::size_t size() const { return labels_.size(); }
   std::size_t dimension() const { return inputs_.dimension(); }
   std::size_t num_instances() const { return inputs_.size(); }
+  // Takes the contents of ins and lbls without copying, leaving them with the old contents
+  bool Swap(Inputs& ins, Labels& lbls) {
+    if (ins.size() != lbls.size()) return false;
+    inputs_.swap(ins);
+    labels_.swap(lbls);
+    return true;
+  }
 
+  // Reads and writes the binary dataset format of binary_dataset.h, with double features
   virtual bool Read(const std::string& path) {
-    std::ifstream inf(path.c_str());
-    if (!inf) return false;
-    std::string line;
-    while (std::getline(inf, line)) {
-
-    }
-    return true;
+    return ReadBinaryDataset(path, this);
+  }
+  virtual bool Write(const std::string& path) {
+    return WriteBinaryDataset<double>(path, *this);
   }
-  virtual bool Write(const std::string& path) { return false; }
   virtual std::string ToString() const {
     return inputs_.ToString();
   }
@@ -136,6 +141,22 @@ public:
     return ret;
   }
 
+  bool Swap(Inputs& ins, Labels& lbls) {
+    bool ret = base_type::Swap(ins, lbls);
+    if (ret) {
+      num_classes_ = CalcNumClasses(labels_);
+    }
+    return ret;
+  }
+
+  virtual bool Read(const std::string& path) {
+    bool ret = base_type::Read(path);
+    if (ret) {
+      num_classes_ = CalcNumClasses(labels_);
+    }
+    return ret;
+  }
+
   std::size_t num_classes() const { return num_classes_; }
 
   virtual std::string ToString() const {
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef TOYML_DATA_DENSE_DATASET_H_
+#define TOYML_DATA_DENSE_DATASET_H_
+
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include <toyml/data/dataset.h>
+
+namespace toyml {
+
+/**
+ * @brief A read-only view of a dense vector stored elsewhere
+ */
+class DenseVector {
+public:
+  typedef double value_type;
+
+  DenseVector(): values_(NULL), size_(0) {}
+  DenseVector(const double* values, std::size_t size): values_(values), size_(size) {}
+
+  std::size_t size() const { return size_; }
+  double operator()(std::size_t i) const { return values_[i]; }
+  double operator[](std::size_t i) const { return values_[i]; }
+  const double* data() const { return values_; }
+  const double* begin() const { return values_; }
+  const double* end() const { return values_ + size_; }
+private:
+  const double* values_;
+  std::size_t size_;
+};
+
+/**
+ * @brief Labeled data whose inputs are the rows of one contiguous row-major buffer
+ *
+ * Rows start on kAlignment byte boundaries: the stride is the dimension
+ * rounded up to a multiple of kAlignment / sizeof(double), and the padding
+ * is 0. Loading fills the buffer in place through mutable_row, so there is
+ * no allocation per instance. BuildColumns adds a column-major copy for
+ * passes over features.
+ */
+template<typename LabelT>
+class DenseLabeledData {
+public:
+  typedef DenseVector Input;
+  typedef LabelT Label;
+  typedef LabelT Output;
+  typedef Data<LabelT> Labels;
+  static const std::size_t kAlignment = 64;
+
+  DenseLabeledData(): rows_(NULL), columns_(NULL), size_(0), dimension_(0), stride_(0) {}
+  DenseLabeledData(const DenseLabeledData& other): rows_(NULL), columns_(NULL) {
+    *this = other;
+  }
+  DenseLabeledData& operator=(const DenseLabeledData& other) {
+    if (this == &other) return *this;
+    Resize(other.size_, other.dimension_);
+    if (size_ > 0) std::memcpy(rows_, other.rows_, size_ * stride_ * sizeof(double));
+    labels_ = other.labels_;
+    if (other.columns_ != NULL) BuildColumns();
+    return *this;
+  }
+  virtual ~DenseLabeledData() {
+    std::free(rows_);
+    std::free(columns_);
+  }
+
+  // Allocates size instances of zero inputs
+  void Resize(std::size_t size, std::size_t dimension) {
+    std::free(rows_);
+    std::free(columns_);
+    columns_ = NULL;
+    size_ = size;
+    dimension_ = dimension;
+    stride_ = RoundUp(dimension);
+    rows_ = Allocate(size_ * stride_);
+    labels_.resize(size_);
+  }
+  // Copies the inputs, which may be of different sizes, and labels
+  template<typename InputC, typename LabelC>
+  bool Init(const InputC& ins, const LabelC& lbls) {
+    if (ins.size() != lbls.size()) return false;
+    std::size_t dimension = 0;
+    for (std::size_t i = 0; i < ins.size(); ++i) {
+      dimension = std::max<std::size_t>(dimension, ins[i].size());
+    }
+    Resize(ins.size(), dimension);
+    for (std::size_t i = 0; i < ins.size(); ++i) {
+      std::copy(ins[i].begin(), ins[i].end(), mutable_row(i));
+      labels_[i] = lbls[i];
+    }
+    return true;
+  }
+  template<typename InputT>
+  bool Init(const LabeledData<InputT, LabelT>& data) {
+    return Init(data.inputs(), data.labels());
+  }
+
+  // Builds the column-major copy of the inputs; it is dropped by Resize
+  void BuildColumns() {
+    std::free(columns_);
+    std::size_t column_stride = RoundUp(size_);
+    columns_ = Allocate(dimension_ * column_stride);
+    for (std::size_t i = 0; i < size_; ++i) {
+      const double* x = row(i);
+      for (std::size_t j = 0; j < dimension_; ++j) {
+        columns_[j * column_stride + i] = x[j];
+      }
+    }
+  }
+  bool has_columns() const { return columns_ != NULL; }
+  // Feature j of all instances, requires BuildColumns
+  const double* column(std::size_t j) const { return columns_ + j * RoundUp(size_); }
+
+  Input input(std::size_t i) const { return Input(row(i), dimension_); }
+  const double* row(std::size_t i) const { return rows_ + i * stride_; }
+  double* mutable_row(std::size_t i) { return rows_ + i * stride_; }
+  const Label& label(std::size_t i) const { return labels_[i]; }
+  Label& label(std::size_t i) { return labels_[i]; }
+  const Labels& labels() const { return labels_; }
+  Labels& labels() { return labels_; }
+  std::size_t size() const { return size_; }
+  std::size_t num_instances() const { return size_; }
+  std::size_t dimension() const { return dimension_; }
+  // distance in doubles between the starts of two consecutive rows
+  std::size_t stride() const { return stride_; }
+
+  virtual std::string ToString() const {
+    std::stringstream ss;
+    ss << "dimension=" << dimension() << ", instances=" << num_instances();
+    return ss.str();
+  }
+protected:
+  double* rows_;
+  double* columns_;
+  std::size_t size_;
+  std::size_t dimension_;
+  std::size_t stride_;
+  Labels labels_;
+
+  static std::size_t RoundUp(std::size_t n) {
+    const std::size_t k = kAlignment / sizeof(double);
+    return (n + k - 1) / k * k;
+  }
+  static double* Allocate(std::size_t n) {
+    void* p = NULL;
+    CHECK_EQ(0, posix_memalign(&p, kAlignment, std::max<std::size_t>(n, 1) * sizeof(double)))
+        << "Failed to allocate " << n << " doubles";
+    std::memset(p, 0, n * sizeof(double));
+    return static_cast<double*>(p);
+  }
+};
+
+typedef DenseLabeledData<RealVector> DenseNNetData;
+
+class DenseClassificationData: public DenseLabeledData<uint32_t> {
+public:
+  // 1 + the largest label, computed on each call
+  std::size_t num_classes() const {
+    uint32_t n = 0;
+    for (std::size_t i = 0; i < size_; ++i) {
+      n = std::max(n, labels_(i));
+    }
+    return size_ > 0 ? n + 1 : 0;
+  }
+
+  virtual std::string ToString() const {
+    return DenseLabeledData<uint32_t>::ToString() + ", classes=" +
+        boost::lexical_cast<std::string>(num_classes());
+  }
+};
+
+} /* namespace toyml */
+#endif /* TOYML_DATA_DENSE_DATASET_H_ */
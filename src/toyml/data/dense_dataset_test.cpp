@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "dense_dataset.h"
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+TEST(DenseClassificationData, Init) {
+  std::vector<RealVector> inputs(3, RealVector(3, 1));
+  inputs[1] = RealVector(2, 2);
+  inputs[2](2) = 5;
+  std::vector<uint32_t> labels(3, 0);
+  labels[2] = 3;
+  DenseClassificationData data;
+  ASSERT_TRUE(data.Init(inputs, labels));
+  EXPECT_EQ(3U, data.size());
+  EXPECT_EQ(3U, data.dimension());
+  EXPECT_EQ(4U, data.num_classes());
+  EXPECT_EQ(0U, data.stride() % (DenseClassificationData::kAlignment / sizeof(double)));
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(data.row(i)) % DenseClassificationData::kAlignment);
+  }
+  DenseVector x = data.input(1);
+  ASSERT_EQ(3U, x.size());
+  EXPECT_DOUBLE_EQ(2, x(0));
+  EXPECT_DOUBLE_EQ(0, x(2));
+  EXPECT_DOUBLE_EQ(5, data.input(2)(2));
+
+  data.BuildColumns();
+  ASSERT_TRUE(data.has_columns());
+  EXPECT_DOUBLE_EQ(1, data.column(2)[0]);
+  EXPECT_DOUBLE_EQ(0, data.column(2)[1]);
+  EXPECT_DOUBLE_EQ(5, data.column(2)[2]);
+
+  DenseClassificationData copy(data);
+  EXPECT_EQ(data.labels(), copy.labels());
+  EXPECT_DOUBLE_EQ(5, copy.input(2)(2));
+  EXPECT_DOUBLE_EQ(5, copy.column(2)[2]);
+}
+
+} /* namespace toyml */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef TOYML_DATA_SPARSE_DATASET_H_
+#define TOYML_DATA_SPARSE_DATASET_H_
+
+#include <stdint.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include <toyml/data/dataset.h>
+
+namespace toyml {
+
+/**
+ * @brief A read-only view of a sparse vector as parallel index/value arrays
+ */
+class SparseVector {
+public:
+  SparseVector(): indices_(NULL), values_(NULL), nnz_(0) {}
+  SparseVector(const uint32_t* indices, const double* values, std::size_t nnz)
+      : indices_(indices), values_(values), nnz_(nnz) {}
+
+  // number of non-zeros
+  std::size_t size() const { return nnz_; }
+  uint32_t index(std::size_t i) const { return indices_[i]; }
+  double value(std::size_t i) const { return values_[i]; }
+  const uint32_t* indices() const { return indices_; }
+  const double* values() const { return values_; }
+private:
+  const uint32_t* indices_;
+  const double* values_;
+  std::size_t nnz_;
+};
+
+/**
+ * @brief Classification data whose inputs are stored in CSR format
+ *
+ * Row i holds the entries [offsets_[i], offsets_[i + 1]) of indices_ and
+ * values_, so the memory is proportional to the number of non-zeros.
+ */
+class SparseClassificationData {
+public:
+  typedef SparseVector Input;
+  typedef uint32_t Label;
+  typedef uint32_t Output;
+  typedef std::vector<uint32_t> Labels;
+
+  SparseClassificationData(): offsets_(1, 0), dimension_(0), num_classes_(0) {}
+  virtual ~SparseClassificationData() {}
+
+  // Appends an instance whose features are (index, value) pairs
+  void Add(const std::vector<std::pair<uint32_t, double> >& features, Label label) {
+    for (std::size_t i = 0; i < features.size(); ++i) {
+      indices_.push_back(features[i].first);
+      values_.push_back(features[i].second);
+      dimension_ = std::max<std::size_t>(dimension_, features[i].first + 1);
+    }
+    offsets_.push_back(indices_.size());
+    labels_.push_back(label);
+    num_classes_ = std::max<std::size_t>(num_classes_, label + 1);
+  }
+  void Clear() {
+    offsets_.assign(1, 0);
+    indices_.clear();
+    values_.clear();
+    labels_.clear();
+    dimension_ = 0;
+    num_classes_ = 0;
+  }
+
+  Input input(std::size_t i) const {
+    std::size_t begin = offsets_[i];
+    return Input(indices_.data() + begin, values_.data() + begin, offsets_[i + 1] - begin);
+  }
+  const Label& label(std::size_t i) const { return labels_[i]; }
+  const Labels& labels() const { return labels_; }
+  std::size_t size() const { return labels_.size(); }
+  std::size_t num_instances() const { return labels_.size(); }
+  // 1 + the largest feature index
+  std::size_t dimension() const { return dimension_; }
+  std::size_t num_classes() const { return num_classes_; }
+  std::size_t nnz() const { return indices_.size(); }
+
+  /**
+   * @brief Reads data in libsvm format, i.e. "<label> <index>:<value> ..." per line
+   *
+   * Indices are kept as they are, and the features of an instance are
+   * sorted by index.
+   */
+  bool Read(std::istream& is) {
+    if (!is) return false;
+    std::string line;
+    std::vector<std::pair<uint32_t, double> > features;
+    std::size_t lineno = 0;
+    while (std::getline(is, line)) {
+      ++lineno;
+      if (line.empty() || line[0] == '#') continue;
+      const char* p = line.c_str();
+      char* end = NULL;
+      long label = std::strtol(p, &end, 10);
+      if (end == p || label < 0) {
+        LOG(WARNING) << "Invalid label at line " << lineno << ": " << line;
+        continue;
+      }
+      p = end;
+      features.clear();
+      while (true) {
+        unsigned long index = std::strtoul(p, &end, 10);
+        if (end == p || *end != ':') break;
+        p = end + 1;
+        double value = std::strtod(p, &end);
+        if (end == p) break;
+        p = end;
+        features.push_back(std::make_pair(static_cast<uint32_t>(index), value));
+      }
+      std::sort(features.begin(), features.end());
+      Add(features, label);
+    }
+    return true;
+  }
+  bool Read(const std::string& path) {
+    std::ifstream inf(path.c_str());
+    return Read(inf);
+  }
+
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << "dimension=" << dimension() << ", instances=" << num_instances()
+        << ", nnz=" << nnz() << ", classes=" << num_classes();
+    return ss.str();
+  }
+private:
+  std::vector<std::size_t> offsets_;
+  std::vector<uint32_t> indices_;
+  std::vector<double> values_;
+  Labels labels_;
+  std::size_t dimension_;
+  std::size_t num_classes_;
+};
+
+} /* namespace toyml */
+#endif /* TOYML_DATA_SPARSE_DATASET_H_ */
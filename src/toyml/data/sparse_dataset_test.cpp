@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "sparse_dataset.h"
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+TEST(SparseClassificationData, Read) {
+  std::stringstream ss("1 3:0.5 1:2\n# comment\n0\n2 7:-1\n");
+  SparseClassificationData data;
+  ASSERT_TRUE(data.Read(ss));
+  EXPECT_EQ(3U, data.size());
+  EXPECT_EQ(8U, data.dimension());
+  EXPECT_EQ(3U, data.num_classes());
+  EXPECT_EQ(3U, data.nnz());
+
+  SparseVector x = data.input(0);
+  ASSERT_EQ(2U, x.size());
+  EXPECT_EQ(1U, x.index(0));
+  EXPECT_DOUBLE_EQ(2, x.value(0));
+  EXPECT_EQ(3U, x.index(1));
+  EXPECT_DOUBLE_EQ(0.5, x.value(1));
+  EXPECT_EQ(0U, data.input(1).size());
+  EXPECT_EQ(0U, data.label(1));
+  EXPECT_DOUBLE_EQ(-1, data.input(2).value(0));
+  EXPECT_EQ(2U, data.label(2));
+}
+
+} /* namespace toyml */
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "hidden_layer.h"
+#include <glog/logging.h>
+#include <toyml/util/util.h>
+
+namespace toyml {
+namespace dl {
+
+HiddenLayer::HiddenLayer() {
+}
+
+HiddenLayer::~HiddenLayer() {
+}
+
+void HiddenLayer::Train(const Input& x, const Output& y) {
+  Output out;
+  Predict(x, &out);
+
+  for (std::size_t i = 0; i < options_.out; ++i) {
+    double dy = y(i) - out(i);
+    for (std::size_t j = 0; j < options_.in; ++j) {
+      w_(i, j) += dy * x(j) * options_.learning_rate;
+    }
+    b_(i) += dy * options_.learning_rate;
+  }
+}
+
+void HiddenLayer::Predict(const Input& x, Output* y) const {
+  CHECK_EQ(x.size(), options_.in);
+  y->resize(options_.out);
+  for (std::size_t i = 0; i < options_.out; ++i) {
+    ublas::matrix_row<const RealMatrix> wi(w_, i);
+    (*y)(i) = ublas::inner_prod(wi, x) + b_(i);
+  }
+  if (options_.out > 0) Util::Sigmoid(&(*y)[0], options_.out);
+}
+
+void HiddenLayer::Derivative(const RealMatrix& y, std::size_t rows, RealMatrix* delta) const {
+  for (std::size_t r = 0; r < rows; ++r) {
+    const double* yr = &y(r, 0);
+    double* dr = &(*delta)(r, 0);
+    for (std::size_t i = 0; i < options_.out; ++i) {
+      dr[i] *= yr[i] * (1 - yr[i]);
+    }
+  }
+}
+
+void HiddenLayer::Activate(std::size_t rows, RealMatrix* z) const {
+  Util::Sigmoid(&(*z)(0, 0), rows * options_.out);
+}
+
+} /* namespace dl */
+} /* namespace toyml */
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "hidden_layer.h"
+#include <gtest/gtest.h>
+
+namespace toyml {
+namespace dl {
+
+TEST(HiddenLayer, Forward) {
+  HiddenLayer::Options options;
+  options.in = 3;
+  options.out = 2;
+  HiddenLayer layer;
+  ASSERT_TRUE(layer.Init(options));
+
+  RealMatrix x(2, 3, 1);
+  RealMatrix y(2, 2);
+  layer.Forward(x, 2, &y);
+  for (std::size_t r = 0; r < 2; ++r) {
+    for (std::size_t i = 0; i < 2; ++i) {
+      EXPECT_DOUBLE_EQ(0.5, y(r, i));
+    }
+  }
+}
+
+} /* namespace dl */
+} /* namespace toyml */
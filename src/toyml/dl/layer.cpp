@@ -24,11 +24,13 @@
  */
 
 #include "layer.h"
+#include <cstdlib>
 #include <sstream>
 #include <algorithm>
 #include <glog/logging.h>
 
 #include <toyml/util/util.h>
+#include <toyml/util/gemm.h>
 
 namespace toyml {
 namespace dl {
@@ -41,13 +43,20 @@ Layer::~Layer() {
 
 std::string Layer::Options::ToString() const {
   std::stringstream ss;
-  ss << NVC_(in) << NVC_(out) << NVC_(max_iterations) << NV_(learning_rate);
+  ss << NVC_(in) << NVC_(out) << NVC_(max_iterations) << NVC_(learning_rate) << NVC_(batch_size) << NV_(init_range);
   return ss.str();
 }
 
 bool Layer::Init(const Options& options) {
   options_ = options;
   RealMatrix(options_.out, options_.in, 0).swap(w_);
+  if (options_.init_range > 0) {
+    for (std::size_t i = 0; i < options_.out; ++i) {
+      for (std::size_t j = 0; j < options_.in; ++j) {
+        w_(i, j) = (2.0 * std::rand() / RAND_MAX - 1) * options_.init_range;
+      }
+    }
+  }
   RealVector(options_.out, 0).swap(b_);
   return true;
 }
@@ -55,18 +64,94 @@ bool Layer::Init(const Options& options) {
 bool Layer::Train(const NNetData& data) {
   for (std::size_t iter = 0; iter < options_.max_iterations; ++iter) {
     VLOG(2) << "iteration#" << iter;
-    for (std::size_t i = 0; i < data.size(); ++i) {
-      VLOG(4) << "instance#" << i;
-      Train(data.input(i), data.label(i));
+    if (options_.batch_size <= 1) {
+      for (std::size_t i = 0; i < data.size(); ++i) {
+        VLOG(4) << "instance#" << i;
+        Train(data.input(i), data.label(i));
+      }
+    } else {
+      for (std::size_t begin = 0; begin < data.size(); begin += options_.batch_size) {
+        VLOG(4) << "batch#" << begin / options_.batch_size;
+        TrainBatch(data, begin, std::min(begin + options_.batch_size, data.size()));
+      }
     }
   }
   return true;
 }
 
+void Layer::TrainBatch(const NNetData& data, std::size_t begin, std::size_t end) {
+  for (std::size_t i = begin; i < end; ++i) {
+    Train(data.input(i), data.label(i));
+  }
+}
+
 void Layer::Predict(const Input& x, ClassificationData::Output* y) const {
   Output out;
   Predict(x, &out);
-  *y = std::distance(out.begin(), std::max_element(out.begin(), out.begin()));
+  *y = std::distance(out.begin(), std::max_element(out.begin(), out.end()));
+}
+
+void Layer::Predict(const Inputs& inputs, ClassificationData::Outputs* outputs) const {
+  outputs->resize(inputs.size());
+  std::size_t nblocks = (inputs.size() + predict_block_size_ - 1) / predict_block_size_;
+#pragma omp parallel for schedule(dynamic) num_threads(PredictThreads(nblocks))
+  for (std::size_t block = 0; block < nblocks; ++block) {
+    std::size_t begin = block * predict_block_size_;
+    std::size_t end = std::min(begin + predict_block_size_, inputs.size());
+    PredictBlock(inputs, begin, end, outputs);
+  }
+}
+
+void Layer::PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+    ClassificationData::Outputs* outputs) const {
+  for (std::size_t i = begin; i < end; ++i) {
+    Predict(inputs[i], &(*outputs)[i]);
+  }
+}
+
+bool Layer::Train(const DenseNNetData& data) {
+  std::size_t batch_size = std::max<std::size_t>(options_.batch_size, 1);
+  RealMatrix delta(batch_size, options_.out);
+  for (std::size_t iter = 0; iter < options_.max_iterations; ++iter) {
+    VLOG(2) << "iteration#" << iter;
+    for (std::size_t begin = 0; begin < data.size(); begin += batch_size) {
+      std::size_t rows = std::min(batch_size, data.size() - begin);
+      Forward(data.row(begin), data.stride(), rows, &delta);
+      for (std::size_t r = 0; r < rows; ++r) {
+        const Output& y = data.label(begin + r);
+        for (std::size_t i = 0; i < options_.out; ++i) {
+          delta(r, i) = y(i) - delta(r, i);
+        }
+      }
+      Backward(data.row(begin), data.stride(), delta, rows, NULL);
+    }
+  }
+  return true;
+}
+
+void Layer::Forward(const double* x, std::size_t ldx, std::size_t rows, RealMatrix* y) const {
+  // y = x * w_^T + b_: every panel of w_ is reused across the rows while it is in cache
+  for (std::size_t r = 0; r < rows; ++r) {
+    std::copy(b_.begin(), b_.end(), &(*y)(r, 0));
+  }
+  Gemm(false, true, rows, options_.out, options_.in, 1, x, ldx,
+      &w_(0, 0), options_.in, 1, &(*y)(0, 0), y->size2());
+  Activate(rows, y);
+}
+
+void Layer::Backward(const double* x, std::size_t ldx, const RealMatrix& delta,
+    std::size_t rows, RealMatrix* delta_in) {
+  if (delta_in) {
+    Gemm(false, false, rows, options_.in, options_.out, 1, &delta(0, 0), delta.size2(),
+        &w_(0, 0), options_.in, 0, &(*delta_in)(0, 0), delta_in->size2());
+  }
+  for (std::size_t r = 0; r < rows; ++r) {
+    for (std::size_t i = 0; i < options_.out; ++i) {
+      b_(i) += delta(r, i) * options_.learning_rate;
+    }
+  }
+  Gemm(true, false, options_.out, options_.in, rows, options_.learning_rate,
+      &delta(0, 0), delta.size2(), x, ldx, 1, &w_(0, 0), options_.in);
 }
 
 std::string Layer::ToString() const {
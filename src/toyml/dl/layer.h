@@ -31,6 +31,7 @@
 #include <toyml/common/ito_string.h>
 #include <toyml/util/util.h>
 #include <toyml/data/dataset.h>
+#include <toyml/data/dense_dataset.h>
 #include <toyml/model/model.h>
 
 
@@ -47,12 +48,15 @@ class Layer : public IToString , public Model<RealVector, RealVector> {
  public:
   typedef Model<RealVector, RealVector> Model;
   struct Options : public IToString {
-    Options(): in(4), out(2), max_iterations(10), learning_rate(0.01) {}
+    Options(): in(4), out(2), max_iterations(10), learning_rate(0.01), batch_size(1),
+        init_range(0) {}
     virtual std::string ToString() const;
     std::size_t in;         ///< input dimension
     std::size_t out;        ///< output dimension
     std::size_t max_iterations;        ///< maximum iterations
     double learning_rate;   ///< learning rate
+    std::size_t batch_size; ///< number of instances per update, 1 means updating after every instance
+    double init_range;      ///< initial weights are uniform in [-init_range, init_range]
   };
 
   Layer();
@@ -61,16 +65,42 @@ class Layer : public IToString , public Model<RealVector, RealVector> {
   virtual bool Init(const Options& options);
   virtual bool Train(const NNetData& data);
   virtual void Train(const Input& x, const Output& y) = 0;
+  // Trains on the instances [begin, end) of data with one update
+  virtual void TrainBatch(const NNetData& data, std::size_t begin, std::size_t end);
   using Model::Predict;
+  using Model::PredictBlock;
+  // Predicts the class with the largest output
   virtual void Predict(const Input& x, ClassificationData::Output* y) const;
-  virtual void Predict(const Inputs& inputs, ClassificationData::Outputs* outputs) const {
-    outputs->resize(inputs.size());
-    for (std::size_t i = 0; i < inputs.size(); ++i) {
-      Predict(inputs[i], &(*outputs)[i]);
-    }
-  }
+  virtual void Predict(const Inputs& inputs, ClassificationData::Outputs* outputs) const;
+  virtual void PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+      ClassificationData::Outputs* outputs) const;
   virtual std::string ToString() const;
+
+  // Trains on the contiguous rows of data, in batches of batch_size
+  bool Train(const DenseNNetData& data);
+
+  // Computes the outputs of rows inputs into the rows of y; input r starts at x + r * ldx
+  virtual void Forward(const double* x, std::size_t ldx, std::size_t rows, RealMatrix* y) const;
+  void Forward(const RealMatrix& x, std::size_t rows, RealMatrix* y) const {
+    Forward(&x(0, 0), x.size2(), rows, y);
+  }
+  // Takes the errors delta (target - output, before the activation) of rows
+  // inputs: stores the errors of the inputs into delta_in unless it is NULL,
+  // then moves the weights along the gradients summed over the instances
+  virtual void Backward(const double* x, std::size_t ldx, const RealMatrix& delta,
+      std::size_t rows, RealMatrix* delta_in);
+  void Backward(const RealMatrix& x, const RealMatrix& delta, std::size_t rows,
+      RealMatrix* delta_in) {
+    Backward(&x(0, 0), x.size2(), delta, rows, delta_in);
+  }
+  // Turns the errors of the outputs y into errors before the activation
+  virtual void Derivative(const RealMatrix& y, std::size_t rows, RealMatrix* delta) const = 0;
+
+  const Options& options() const { return options_; }
  protected:
+  // Applies the activation function to the first rows rows of z in place
+  virtual void Activate(std::size_t rows, RealMatrix* z) const = 0;
+
   Options options_;
 
   RealMatrix w_;    ///< w_[i][j] is the weight of the edge between output i and input j
@@ -24,6 +24,9 @@
  */
 
 #include "neural_network.h"
+#include <sstream>
+#include <algorithm>
+#include <glog/logging.h>
 
 namespace toyml {
 namespace dl {
@@ -34,5 +37,107 @@ NeuralNetwork::NeuralNetwork() {
 NeuralNetwork::~NeuralNetwork() {
 }
 
+std::string NeuralNetwork::Options::ToString() const {
+  std::stringstream ss;
+  ss << NVC_(max_iterations) << NV_(batch_size);
+  return ss.str();
+}
+
+bool NeuralNetwork::Init(const Options& options) {
+  options_ = options;
+  if (layers_.empty()) {
+    LOG(ERROR) << "No layers in the network";
+    return false;
+  }
+  if (options_.batch_size == 0) {
+    LOG(ERROR) << "batch_size must be positive";
+    return false;
+  }
+  for (std::size_t i = 1; i < layers_.size(); ++i) {
+    if (layers_[i]->options().in != layers_[i - 1]->options().out) {
+      LOG(ERROR) << "Input dimension of layer#" << i << " " << layers_[i]->options().in
+          << " does not match output dimension of layer#" << i - 1 << " " << layers_[i - 1]->options().out;
+      return false;
+    }
+  }
+
+  acts_.resize(layers_.size() + 1);
+  deltas_.resize(layers_.size());
+  acts_[0].resize(options_.batch_size, input_layer()->options().in, false);
+  for (std::size_t i = 0; i < layers_.size(); ++i) {
+    acts_[i + 1].resize(options_.batch_size, layers_[i]->options().out, false);
+    deltas_[i].resize(options_.batch_size, layers_[i]->options().out, false);
+  }
+  return true;
+}
+
+bool NeuralNetwork::Train(const NNetData& data) {
+  for (std::size_t iter = 0; iter < options_.max_iterations; ++iter) {
+    VLOG(2) << "iteration#" << iter;
+    for (std::size_t begin = 0; begin < data.size(); begin += options_.batch_size) {
+      TrainBatch(data, begin, std::min(begin + options_.batch_size, data.size()));
+    }
+  }
+  return true;
+}
+
+void NeuralNetwork::TrainBatch(const NNetData& data, std::size_t begin, std::size_t end) {
+  std::size_t rows = end - begin;
+  CHECK_LE(rows, options_.batch_size);
+  std::size_t nlayers = layers_.size();
+
+  for (std::size_t r = 0; r < rows; ++r) {
+    const Input& x = data.input(begin + r);
+    CHECK_EQ(x.size(), acts_[0].size2());
+    std::copy(x.begin(), x.end(), &acts_[0](r, 0));
+  }
+  for (std::size_t i = 0; i < nlayers; ++i) {
+    layers_[i]->Forward(acts_[i], rows, &acts_[i + 1]);
+  }
+
+  RealMatrix& out = acts_[nlayers];
+  RealMatrix& delta = deltas_[nlayers - 1];
+  for (std::size_t r = 0; r < rows; ++r) {
+    const Output& y = data.label(begin + r);
+    for (std::size_t i = 0; i < out.size2(); ++i) {
+      delta(r, i) = y(i) - out(r, i);
+    }
+  }
+  // the errors of layer i - 1 are taken before layer i moves its weights
+  for (std::size_t i = nlayers; i-- > 0; ) {
+    if (i > 0) {
+      layers_[i]->Backward(acts_[i], deltas_[i], rows, &deltas_[i - 1]);
+      layers_[i - 1]->Derivative(acts_[i], rows, &deltas_[i - 1]);
+    } else {
+      layers_[i]->Backward(acts_[i], deltas_[i], rows, NULL);
+    }
+  }
+}
+
+void NeuralNetwork::Predict(const Input& x, Output* y) const {
+  Output in = x;
+  for (std::size_t i = 0; i < layers_.size(); ++i) {
+    layers_[i]->Predict(in, y);
+    in.swap(*y);
+  }
+  y->swap(in);
+}
+
+void NeuralNetwork::Predict(const Input& x, ClassificationData::Output* y) const {
+  Output out;
+  Predict(x, &out);
+  *y = std::distance(out.begin(), std::max_element(out.begin(), out.end()));
+}
+
+std::string NeuralNetwork::ToString() const {
+  std::stringstream ss;
+  ss << NVC_(options_) << "layers=[";
+  for (std::size_t i = 0; i < layers_.size(); ++i) {
+    ss << (i ? ", " : "") << layers_[i]->options().ToString();
+  }
+  ss << "]";
+  return ss.str();
+}
+
 } /* namespace dl */
 } /* namespace toyml */
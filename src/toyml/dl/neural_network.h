@@ -34,15 +34,38 @@ namespace toyml {
 namespace dl {
 
 /**
- * @brief 
+ * @brief Feed-forward network of layers trained by backpropagation
+ *
+ * The output of layer i is the input of layer i + 1. The layers are not owned
+ * and keep their own learning rates; the errors of the last layer are the
+ * targets minus its outputs, i.e. the gradient of the cross-entropy loss
+ * for softmax or logistic output units. Training runs mini-batch SGD on
+ * activation and error buffers allocated by Init, so a training step does
+ * not allocate.
  */
-class NeuralNetwork {
+class NeuralNetwork : public IToString {
  public:
   typedef std::vector<Layer*> Layers;
+  struct Options : public IToString {
+    Options(): max_iterations(10), batch_size(32) {}
+    virtual std::string ToString() const;
+    std::size_t max_iterations;   ///< maximum iterations
+    std::size_t batch_size;       ///< number of instances per update
+  };
 
   NeuralNetwork();
   virtual ~NeuralNetwork();
 
+  // Checks the layers are chained and allocates the buffers; call after adding the layers
+  bool Init(const Options& options);
+  bool Train(const NNetData& data);
+  // One forward and backward pass over the instances [begin, end) of data
+  void TrainBatch(const NNetData& data, std::size_t begin, std::size_t end);
+  void Predict(const Input& x, Output* y) const;
+  // Predicts the class with the largest output
+  void Predict(const Input& x, ClassificationData::Output* y) const;
+  virtual std::string ToString() const;
+
   Layers& layers() { return layers_; }
   Layer* layer(std::size_t i) { return layers_[i]; }
   Layer* input_layer() { return layers_.front(); }
@@ -50,7 +73,11 @@ class NeuralNetwork {
 
   std::size_t NumLayers() const { return layers_.size(); }
  private:
+  Options options_;
   Layers layers_;
+
+  std::vector<RealMatrix> acts_;    ///< acts_[0] is the batch, acts_[i + 1] the outputs of layer i
+  std::vector<RealMatrix> deltas_;  ///< deltas_[i] are the errors of layer i before its activation
 };
 
 } /* namespace dl */
@@ -25,12 +25,65 @@
 
 #include "neural_network.h"
 #include <gtest/gtest.h>
+#include "hidden_layer.h"
+#include "sigmoid_layer.h"
 
 namespace toyml {
 namespace dl {
 
-TEST(NeuralNetwork, Method) {
+TEST(NeuralNetwork, Xor) {
+  std::vector<RealVector> inputs(4, RealVector(2));
+  std::vector<RealVector> targets(4, RealVector(2, 0));
+  for (std::size_t i = 0; i < 4; ++i) {
+    inputs[i](0) = i & 1;
+    inputs[i](1) = (i >> 1) & 1;
+    targets[i]((i & 1) ^ ((i >> 1) & 1)) = 1;
+  }
+  NNetData data;
+  ASSERT_TRUE(data.Init(inputs, targets));
 
+  Layer::Options hidden_options;
+  hidden_options.in = 2;
+  hidden_options.out = 4;
+  hidden_options.learning_rate = 0.5;
+  hidden_options.init_range = 1;
+  HiddenLayer hidden;
+  ASSERT_TRUE(hidden.Init(hidden_options));
+  Layer::Options output_options = hidden_options;
+  output_options.in = 4;
+  output_options.out = 2;
+  SigmoidLayer output;
+  ASSERT_TRUE(output.Init(output_options));
+
+  NeuralNetwork network;
+  network.layers().push_back(&hidden);
+  network.layers().push_back(&output);
+  NeuralNetwork::Options options;
+  options.max_iterations = 5000;
+  options.batch_size = 4;
+  ASSERT_TRUE(network.Init(options));
+  ASSERT_TRUE(network.Train(data));
+
+  for (std::size_t i = 0; i < 4; ++i) {
+    ClassificationData::Output label;
+    network.Predict(inputs[i], &label);
+    EXPECT_EQ(targets[i](1), label) << "input#" << i;
+  }
+}
+
+TEST(NeuralNetwork, MismatchedLayers) {
+  Layer::Options options;
+  options.in = 3;
+  options.out = 4;
+  HiddenLayer hidden;
+  ASSERT_TRUE(hidden.Init(options));
+  SigmoidLayer output;
+  ASSERT_TRUE(output.Init(options));
+
+  NeuralNetwork network;
+  network.layers().push_back(&hidden);
+  network.layers().push_back(&output);
+  EXPECT_FALSE(network.Init(NeuralNetwork::Options()));
 }
 
 } /* namespace dl */
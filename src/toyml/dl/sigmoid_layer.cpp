@@ -24,6 +24,7 @@
  */
 
 #include "sigmoid_layer.h"
+#include <algorithm>
 #include <glog/logging.h>
 #include <toyml/common/common.h>
 #include <toyml/util/util.h>
@@ -50,6 +51,30 @@ void SigmoidLayer::Train(const Input& x, const Output& y) {
   }
 }
 
+void SigmoidLayer::TrainBatch(const NNetData& data, std::size_t begin, std::size_t end) {
+  std::size_t rows = end - begin;
+  if (batch_x_.size1() < rows || batch_x_.size2() != options_.in) {
+    batch_x_.resize(rows, options_.in, false);
+  }
+  if (batch_delta_.size1() < rows || batch_delta_.size2() != options_.out) {
+    batch_delta_.resize(rows, options_.out, false);
+  }
+  for (std::size_t r = 0; r < rows; ++r) {
+    const Input& x = data.input(begin + r);
+    CHECK_EQ(x.size(), options_.in);
+    std::copy(x.begin(), x.end(), &batch_x_(r, 0));
+  }
+  Forward(batch_x_, rows, &batch_delta_);
+  for (std::size_t r = 0; r < rows; ++r) {
+    const Output& y = data.label(begin + r);
+    double* delta = &batch_delta_(r, 0);
+    for (std::size_t i = 0; i < options_.out; ++i) {
+      delta[i] = y(i) - delta[i];
+    }
+  }
+  Backward(batch_x_, batch_delta_, rows, NULL);
+}
+
 void SigmoidLayer::Predict(const Input& x, Output* y) const {
   y->resize(options_.out);
   for (std::size_t i = 0; i < options_.out; ++i) {
@@ -59,5 +84,55 @@ void SigmoidLayer::Predict(const Input& x, Output* y) const {
   Util::Softmax(*y);
 }
 
+void SigmoidLayer::PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+    Outputs* outputs) const {
+  RealMatrix probs;
+  Forward(inputs, begin, end, &probs);
+  for (std::size_t i = begin; i < end; ++i) {
+    (*outputs)[i] = ublas::row(probs, i - begin);
+  }
+}
+
+void SigmoidLayer::PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+    ClassificationData::Outputs* outputs) const {
+  RealMatrix probs;
+  Forward(inputs, begin, end, &probs);
+  for (std::size_t i = begin; i < end; ++i) {
+    const double* p = &probs(i - begin, 0);
+    (*outputs)[i] = std::max_element(p, p + options_.out) - p;
+  }
+}
+
+void SigmoidLayer::Forward(const Inputs& inputs, std::size_t begin, std::size_t end,
+    RealMatrix* probs) const {
+  RealMatrix x(end - begin, options_.in);
+  for (std::size_t r = 0; r < end - begin; ++r) {
+    const Input& input = inputs[begin + r];
+    CHECK_EQ(input.size(), options_.in);
+    std::copy(input.begin(), input.end(), &x(r, 0));
+  }
+  probs->resize(end - begin, options_.out, false);
+  Forward(x, end - begin, probs);
+}
+
+void SigmoidLayer::Derivative(const RealMatrix& y, std::size_t rows, RealMatrix* delta) const {
+  // Jacobian of softmax: dz_i = y_i * (dy_i - sum_j y_j * dy_j)
+  for (std::size_t r = 0; r < rows; ++r) {
+    const double* yr = &y(r, 0);
+    double* dr = &(*delta)(r, 0);
+    double dot = 0;
+    for (std::size_t i = 0; i < options_.out; ++i) {
+      dot += yr[i] * dr[i];
+    }
+    for (std::size_t i = 0; i < options_.out; ++i) {
+      dr[i] = yr[i] * (dr[i] - dot);
+    }
+  }
+}
+
+void SigmoidLayer::Activate(std::size_t rows, RealMatrix* z) const {
+  Util::Softmax(&(*z)(0, 0), rows, options_.out);
+}
+
 } /* namespace dl */
 } /* namespace toyml */
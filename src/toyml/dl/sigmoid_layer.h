@@ -41,8 +41,25 @@ class SigmoidLayer : public Layer {
 
   using Layer::Train;
   virtual void Train(const Input& x, const Output& y);
+  virtual void TrainBatch(const NNetData& data, std::size_t begin, std::size_t end);
   using Layer::Predict;
   virtual void Predict(const Input& x, Output* y) const;
+  virtual void PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+      Outputs* outputs) const;
+  virtual void PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+      ClassificationData::Outputs* outputs) const;
+  using Layer::Forward;
+  virtual void Derivative(const RealMatrix& y, std::size_t rows, RealMatrix* delta) const;
+ protected:
+  // softmax of every row
+  virtual void Activate(std::size_t rows, RealMatrix* z) const;
+ private:
+  // Computes the softmax outputs of inputs [begin, end) into the rows of probs
+  void Forward(const Inputs& inputs, std::size_t begin, std::size_t end, RealMatrix* probs) const;
+
+  // buffers of TrainBatch, kept across batches to avoid reallocation
+  RealMatrix batch_x_;      ///< inputs of the batch, one per row
+  RealMatrix batch_delta_;  ///< outputs of the batch, then the errors y - out
 };
 
 } /* namespace dl */
@@ -24,13 +24,50 @@
  */
 
 #include "sigmoid_layer.h"
+#include <cstdlib>
 #include <gtest/gtest.h>
 
 namespace toyml {
 namespace dl {
 
-TEST(SigmoidLayer, Method) {
+TEST(SigmoidLayer, PredictBlocks) {
+  std::srand(0);
+  SigmoidLayer::Options options;
+  options.in = 5;
+  options.out = 3;
+  options.init_range = 1;
+  SigmoidLayer layer;
+  ASSERT_TRUE(layer.Init(options));
 
+  // 3 does not divide 20, so the last block is partial
+  SigmoidLayer::Inputs inputs;
+  inputs.resize(20);
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i].resize(options.in);
+    for (std::size_t j = 0; j < options.in; ++j) {
+      inputs[i](j) = 2.0 * std::rand() / RAND_MAX - 1;
+    }
+  }
+  layer.set_predict_block_size(3);
+  layer.set_predict_threads(2);
+
+  SigmoidLayer::Outputs probs;
+  layer.Predict(inputs, &probs);
+  ClassificationData::Outputs classes;
+  layer.Predict(inputs, &classes);
+  ASSERT_EQ(inputs.size(), probs.size());
+  ASSERT_EQ(inputs.size(), classes.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    Output expected;
+    layer.Predict(inputs[i], &expected);
+    ASSERT_EQ(options.out, probs[i].size());
+    for (std::size_t k = 0; k < options.out; ++k) {
+      EXPECT_NEAR(expected(k), probs[i](k), 1e-12) << "i=" << i << ", k=" << k;
+    }
+    ClassificationData::Output expected_class;
+    layer.Predict(inputs[i], &expected_class);
+    EXPECT_EQ(expected_class, classes[i]) << "i=" << i;
+  }
 }
 
 } /* namespace dl */
@@ -27,6 +27,8 @@
 #define MODEL_H_
 
 #include <string>
+#include <algorithm>
+#include <omp.h>
 
 #include <toyml/common/inameable.h>
 #include <toyml/data/dataset.h>
@@ -44,15 +46,27 @@ public:
   typedef Data<InputT> Inputs;
   typedef Data<OutputT> Outputs;
 
+  Model(): predict_block_size_(256), predict_threads_(0) {}
   virtual ~Model() {}
 
   virtual std::string name() const { return "Model"; }
 
   virtual void Predict(const Input& input, Output* output) const = 0;
+  // Predicts the inputs block by block, and the blocks in parallel
   virtual void Predict(const Inputs& inputs, Outputs* outputs) const {
     outputs->resize(inputs.size());
-    Output output;
-    for (std::size_t i = 0; i < inputs.size(); ++i) {
+    std::size_t nblocks = (inputs.size() + predict_block_size_ - 1) / predict_block_size_;
+#pragma omp parallel for schedule(dynamic) num_threads(PredictThreads(nblocks))
+    for (std::size_t block = 0; block < nblocks; ++block) {
+      std::size_t begin = block * predict_block_size_;
+      std::size_t end = std::min(begin + predict_block_size_, inputs.size());
+      PredictBlock(inputs, begin, end, outputs);
+    }
+  }
+  // Predicts inputs [begin, end) into the same entries of outputs
+  virtual void PredictBlock(const Inputs& inputs, std::size_t begin, std::size_t end,
+      Outputs* outputs) const {
+    for (std::size_t i = begin; i < end; ++i) {
       Predict(inputs[i], &(*outputs)[i]);
     }
   }
@@ -69,6 +83,21 @@ public:
 
   virtual bool Read(const std::string& path) { return false; }
   virtual bool Write(const std::string& path) { return false; }
+
+  // number of inputs predicted together, at least 1
+  void set_predict_block_size(std::size_t size) { predict_block_size_ = std::max<std::size_t>(size, 1); }
+  std::size_t predict_block_size() const { return predict_block_size_; }
+  // number of threads predicting blocks, 0 means all cores
+  void set_predict_threads(std::size_t threads) { predict_threads_ = threads; }
+  std::size_t predict_threads() const { return predict_threads_; }
+protected:
+  std::size_t predict_block_size_;
+  std::size_t predict_threads_;
+
+  int PredictThreads(std::size_t nblocks) const {
+    std::size_t threads = predict_threads_ ? predict_threads_ : omp_get_max_threads();
+    return std::max<std::size_t>(std::min(threads, nblocks), 1);
+  }
 };
 
 } /* namespace toyml */
@@ -8,6 +8,7 @@
 #include "dataset.h"
 
 #include <fstream>
+#include <set>
 #include <boost/algorithm/string.hpp>
 #include <glog/logging.h>
 
@@ -15,15 +16,15 @@ namespace toyml {
 
 static const std::string kSeperator = " \t\r\n";
 
-DocumentSet::DocumentSet(): woccurs_(0), idx2freq_done_(false) {
+const uint32_t Document::kNoWord;
+
+DocumentSet::DocumentSet(): packed_(false), woccurs_(0), idx2freq_done_(false) {
 }
 
 DocumentSet::~DocumentSet() {
 }
 
 bool DocumentSet::Load(const std::string& fname) {
-  typedef std::map<uint32_t, uint32_t> Word2Freq;
-
   std::ifstream inf(fname);
   if (!inf) {
     LOG(ERROR) << "Failed to open data file " << fname;
@@ -32,26 +33,9 @@ bool DocumentSet::Load(const std::string& fname) {
 
   Clear();
   std::string line;
-  std::vector<std::string> tokens;
   while (std::getline(inf, line)) {
-      boost::trim(line);
-    boost::split(tokens, line, boost::is_any_of(kSeperator), boost::token_compress_on);
-    Word2Freq word2freq;
-    for (std::size_t i = 0; i < tokens.size(); ++i) {
-        if (tokens[i].size() == 0) continue;
-      uint32_t word = Index(tokens[i]);
-      Word2Freq::iterator it = word2freq.find(word);
-      if (it == word2freq.end()) {
-        word2freq[word] = 1;
-      } else {
-        ++it->second;
-      }
-    }
-    Document doc;
-    for (Word2Freq::const_iterator it = word2freq.begin(); it != word2freq.end(); ++it) {
-      doc.Add(it->first, it->second);
-    }
-    docs_.push_back(doc);
+    docs_.push_back(Document());
+    ParseDoc(line, &docs_.back());
   }
 
   // build posting lists
@@ -66,6 +50,246 @@ bool DocumentSet::Load(const std::string& fname) {
   return true;
 }
 
+std::size_t DocumentSet::LoadNext(std::istream& is, std::size_t ndocs) {
+  docs_.clear();
+  posts_.clear();
+  ClearPacked();
+  woccurs_ = 0;
+  idx2freq_done_ = false;
+  std::string line;
+  while (docs_.size() < ndocs && std::getline(is, line)) {
+    docs_.push_back(Document());
+    ParseDoc(line, &docs_.back());
+  }
+  return docs_.size();
+}
+
+std::size_t DocumentSet::LoadNextBinary(std::istream& is, std::size_t ndocs) {
+  docs_.clear();
+  posts_.clear();
+  ClearPacked();
+  woccurs_ = 0;
+  idx2freq_done_ = false;
+  uint32_t size = 0;
+  std::vector<uint32_t> buf;
+  while (docs_.size() < ndocs && is.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    buf.resize(2 * size);
+    if (size > 0 && !is.read(reinterpret_cast<char*>(&buf[0]), buf.size() * sizeof(buf[0]))) {
+      LOG(ERROR) << "Truncated binary document #" << docs_.size();
+      break;
+    }
+    docs_.push_back(Document());
+    for (uint32_t i = 0; i < size; ++i) {
+      docs_.back().Add(buf[2 * i], buf[2 * i + 1]);
+    }
+  }
+  return docs_.size();
+}
+
+bool DocumentSet::WriteBinary(std::ostream& os) const {
+  std::vector<uint32_t> buf;
+  for (std::size_t d = 0; d < DocSize(); ++d) {
+    EntryReader reader = DocReader(d);
+    buf.resize(1 + 2 * reader.Size());
+    buf[0] = reader.Size();
+    uint32_t* entry = buf.data() + 1;
+    for (uint32_t w, n; reader.Next(&w, &n); entry += 2) {
+      entry[0] = w;
+      entry[1] = n;
+    }
+    os.write(reinterpret_cast<const char*>(&buf[0]), buf.size() * sizeof(buf[0]));
+  }
+  return os.good();
+}
+
+bool DocumentSet::LoadDict(const std::string& path) {
+  std::ifstream inf(path.c_str());
+  if (!inf) {
+    LOG(ERROR) << "Failed to open dictionary file " << path;
+    return false;
+  }
+  Clear();
+  std::size_t size = 0;
+  inf >> size;
+  words_.resize(size);
+  std::string word;
+  uint32_t idx = 0;
+  while (inf >> word >> idx) {
+    if (idx >= size) {
+      LOG(ERROR) << "Invalid word id " << idx << " of " << word << " in " << path;
+      return false;
+    }
+    word2idx_[word] = idx;
+    words_[idx] = word;
+  }
+  return word2idx_.size() == size;
+}
+
+static bool MoreFrequent(const std::pair<std::size_t, uint32_t>& a,
+    const std::pair<std::size_t, uint32_t>& b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+void DocumentSet::RemapByFrequency() {
+  typedef std::pair<std::size_t, uint32_t> FreqIdx;
+
+  std::vector<FreqIdx> order(DictSize());
+  for (uint32_t w = 0; w < order.size(); ++w) {
+    order[w] = FreqIdx(0, w);
+  }
+  for (std::size_t d = 0; d < DocSize(); ++d) {
+    EntryReader reader = DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      order[w].first += n;
+    }
+  }
+  std::sort(order.begin(), order.end(), MoreFrequent);
+
+  std::vector<uint32_t> ids(order.size());
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    ids[order[i].second] = i;
+  }
+  Renumber(ids, ids.size());
+}
+
+bool DocumentSet::Prune(const PruneOptions& options) {
+  typedef std::pair<std::size_t, uint32_t> FreqIdx;
+
+  std::set<std::string> stopwords;
+  if (!options.stopwords.empty()) {
+    std::ifstream inf(options.stopwords.c_str());
+    if (!inf) {
+      LOG(ERROR) << "Failed to open stopword file " << options.stopwords;
+      return false;
+    }
+    std::string word;
+    while (inf >> word) {
+      stopwords.insert(word);
+    }
+  }
+
+  std::vector<std::size_t> dfs(DictSize(), 0);
+  std::vector<std::size_t> freqs(DictSize(), 0);
+  for (std::size_t d = 0; d < DocSize(); ++d) {
+    EntryReader reader = DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      ++dfs[w];
+      freqs[w] += n;
+    }
+  }
+
+  double max_df = options.max_df * DocSize();
+  std::vector<FreqIdx> kept;
+  for (uint32_t w = 0; w < dfs.size(); ++w) {
+    if (dfs[w] < options.min_df || dfs[w] > max_df || stopwords.count(words_[w])) {
+      continue;
+    }
+    kept.push_back(FreqIdx(freqs[w], w));
+  }
+  if (options.max_words > 0 && kept.size() > options.max_words) {
+    std::nth_element(kept.begin(), kept.begin() + options.max_words, kept.end(), MoreFrequent);
+    kept.resize(options.max_words);
+  }
+
+  std::vector<bool> keep(DictSize(), false);
+  for (std::size_t i = 0; i < kept.size(); ++i) {
+    keep[kept[i].second] = true;
+  }
+  std::vector<uint32_t> ids(DictSize(), Document::kNoWord);
+  uint32_t size = 0;
+  for (uint32_t w = 0; w < ids.size(); ++w) {
+    if (keep[w]) {
+      ids[w] = size++;
+    }
+  }
+  VLOG(0) << "Pruned " << DictSize() - size << " of " << DictSize() << " words, " << options.ToString();
+  Renumber(ids, size);
+  return true;
+}
+
+void DocumentSet::Renumber(const std::vector<uint32_t>& ids, uint32_t size) {
+  CHECK(!packed_) << "Renumber words of a packed DocumentSet";
+  std::vector<std::string> words(size);
+  Word2Idx word2idx;
+  for (uint32_t w = 0; w < words_.size(); ++w) {
+    if (ids[w] != Document::kNoWord) {
+      words[ids[w]] = words_[w];
+      word2idx[words_[w]] = ids[w];
+    }
+  }
+  words_.swap(words);
+  word2idx_.swap(word2idx);
+  for (std::size_t d = 0; d < docs_.size(); ++d) {
+    docs_[d].Remap(ids);
+  }
+  if (!posts_.empty()) {
+    std::vector<PostingList> posts(size);
+    for (uint32_t w = 0; w < posts_.size(); ++w) {
+      if (ids[w] != Document::kNoWord) {
+        posts[ids[w]] = posts_[w];
+      }
+    }
+    posts_.swap(posts);
+  }
+  woccurs_ = 0;
+  idx2freq_done_ = false;
+}
+
+void DocumentSet::Pack() {
+  if (packed_) return;
+  doc_pack_.offsets.reserve(docs_.size() + 1);
+  doc_pack_.lengths.reserve(docs_.size());
+  for (std::size_t d = 0; d < docs_.size(); ++d) {
+    doc_pack_.Append(docs_[d]);
+  }
+  doc_pack_.offsets.push_back(doc_pack_.bytes.size());
+  post_pack_.offsets.reserve(posts_.size() + 1);
+  post_pack_.lengths.reserve(posts_.size());
+  for (std::size_t w = 0; w < posts_.size(); ++w) {
+    post_pack_.Append(posts_[w]);
+  }
+  post_pack_.offsets.push_back(post_pack_.bytes.size());
+  std::vector<Document>().swap(docs_);
+  std::vector<PostingList>().swap(posts_);
+  packed_ = true;
+}
+
+std::size_t DocumentSet::EntryBytes() const {
+  if (packed_) {
+    return doc_pack_.bytes.size() + post_pack_.bytes.size();
+  }
+  std::size_t entries = 0;
+  for (std::size_t d = 0; d < docs_.size(); ++d) {
+    entries += docs_[d].Size();
+  }
+  for (std::size_t w = 0; w < posts_.size(); ++w) {
+    entries += posts_[w].Size();
+  }
+  return entries * sizeof(EntryReader::Entry);
+}
+
+void DocumentSet::ParseDoc(const std::string& line, Document* doc) {
+  typedef std::map<uint32_t, uint32_t> Word2Freq;
+
+  std::string text = boost::trim_copy(line);
+  std::vector<std::string> tokens;
+  boost::split(tokens, text, boost::is_any_of(kSeperator), boost::token_compress_on);
+  Word2Freq word2freq;
+  for (std::size_t i = 0; i < tokens.size(); ++i) {
+    if (tokens[i].size() == 0) continue;
+    uint32_t word = Index(tokens[i]);
+    Word2Freq::iterator it = word2freq.find(word);
+    if (it == word2freq.end()) {
+      word2freq[word] = 1;
+    } else {
+      ++it->second;
+    }
+  }
+  for (Word2Freq::const_iterator it = word2freq.begin(); it != word2freq.end(); ++it) {
+    doc->Add(it->first, it->second);
+  }
+}
+
 
 bool DocumentSet::CalcWordFreq() const {
   if (idx2freq_done_) return true;
@@ -73,10 +297,8 @@ bool DocumentSet::CalcWordFreq() const {
   idx2freq_.clear();
   std::size_t total_freq = 0;
   for (std::size_t i = 0; i < DocSize(); ++i) {
-    const Document& doc = Doc(i);
-    for (std::size_t j = 0; j < doc.Size(); ++j) {
-      std::size_t word = doc.Word(j);
-      std::size_t freq = doc.Freq(j);
+    EntryReader reader = DocReader(i);
+    for (uint32_t word, freq; reader.Next(&word, &freq); ) {
       idx2freq_[word] += freq;
       total_freq += freq;
     }
@@ -14,14 +14,78 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <algorithm>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <glog/logging.h>
 
 namespace toyml {
 
 namespace ublas = boost::numeric::ublas;
 
+/**
+ * @brief Sequential reader of the (id, frequency) entries of a document or posting list
+ *
+ * Reads either plain entries or their packed form, in which the ascending
+ * ids are delta encoded and ids and frequencies are stored as
+ * variable-byte integers, 7 bits per byte with the high bit set on all
+ * bytes but the last.
+ */
+class EntryReader {
+public:
+  typedef std::pair<uint32_t, uint32_t> Entry;
+
+  EntryReader(const Entry* entries, uint32_t size) :
+      entries_(entries), bytes_(NULL), left_(size), id_(0) {
+  }
+  EntryReader(const uint8_t* bytes, uint32_t size) :
+      entries_(NULL), bytes_(bytes), left_(size), id_(0) {
+  }
+  uint32_t Size() const {
+    return left_;
+  }
+  bool Next(uint32_t* id, uint32_t* freq) {
+    if (left_ == 0) return false;
+    --left_;
+    if (entries_ != NULL) {
+      *id = entries_->first;
+      *freq = entries_->second;
+      ++entries_;
+    } else {
+      id_ += ReadVarint();
+      *id = id_;
+      *freq = ReadVarint();
+    }
+    return true;
+  }
+  static void WriteVarint(uint32_t v, std::vector<uint8_t>* out) {
+    while (v >= 0x80) {
+      out->push_back(static_cast<uint8_t>(v) | 0x80);
+      v >>= 7;
+    }
+    out->push_back(static_cast<uint8_t>(v));
+  }
+private:
+  const Entry* entries_;
+  const uint8_t* bytes_;
+  uint32_t left_;
+  uint32_t id_;
+
+  uint32_t ReadVarint() {
+    uint32_t b = *bytes_++;
+    if (b < 0x80) return b;
+    uint32_t v = b & 0x7F;
+    for (int shift = 7; ; shift += 7) {
+      b = *bytes_++;
+      v |= (b & 0x7F) << shift;
+      if (b < 0x80) return v;
+    }
+  }
+};
+
 class Document {
 public:
+  static const uint32_t kNoWord = 0xFFFFFFFF;
+
   void Add(uint32_t word, uint32_t freq) {
     lis_.push_back(WordFreq(word, freq));
   }
@@ -34,6 +98,22 @@ public:
   uint32_t Size() const {
     return lis_.size();
   }
+  EntryReader Reader() const {
+    return EntryReader(lis_.empty() ? NULL : &lis_[0], lis_.size());
+  }
+  // Renames every word w to ids[w], drops the words mapped to kNoWord and
+  // keeps the entries sorted by word
+  void Remap(const std::vector<uint32_t>& ids) {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < lis_.size(); ++i) {
+      uint32_t word = ids[lis_[i].first];
+      if (word != kNoWord) {
+        lis_[size++] = WordFreq(word, lis_[i].second);
+      }
+    }
+    lis_.resize(size);
+    std::sort(lis_.begin(), lis_.end());
+  }
   std::string ToString() const {
     std::stringstream ss;
     ss << Size() << ":";
@@ -62,6 +142,9 @@ public:
   uint32_t Size() const {
     return lis_.size();
   }
+  EntryReader Reader() const {
+    return EntryReader(lis_.empty() ? NULL : &lis_[0], lis_.size());
+  }
   std::string ToString() const {
     std::stringstream ss;
     ss << Size() << ":";
@@ -76,6 +159,28 @@ private:
   DocFreqList lis_;
 };
 
+/**
+ * @brief Vocabulary pruning applied to a loaded corpus by DocumentSet::Prune
+ */
+struct PruneOptions {
+  std::size_t min_df;     // drop words occurring in fewer documents
+  double max_df;          // drop words occurring in more than this fraction of documents
+  std::size_t max_words;  // keep at most the max_words most frequent words, 0 means no limit
+  std::string stopwords;  // path of a whitespace separated stopword list, empty means none
+  PruneOptions() :
+      min_df(1), max_df(1.0), max_words(0) {
+  }
+  bool Enabled() const {
+    return min_df > 1 || max_df < 1.0 || max_words > 0 || !stopwords.empty();
+  }
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << "min_df=" << min_df << ", max_df=" << max_df << ", max_words=" << max_words
+        << ", stopwords=" << stopwords;
+    return ss.str();
+  }
+};
+
 /**
  * @brief 
  */
@@ -84,14 +189,68 @@ public:
   DocumentSet();
   virtual ~DocumentSet();
   bool Load(const std::string& fname);
+  // Replaces the documents with the next ndocs documents of the stream while
+  // keeping the dictionary, so a corpus can be processed in mini-batches.
+  // Posting lists are not built. Returns the number of documents read.
+  std::size_t LoadNext(std::istream& is, std::size_t ndocs);
+  // Same as LoadNext but reads documents written by WriteBinary
+  std::size_t LoadNextBinary(std::istream& is, std::size_t ndocs);
+  // Appends the documents in binary format: for each document, the number of
+  // entries and then the (word, frequency) pairs, all as uint32_t.
+  bool WriteBinary(std::ostream& os) const;
+  // Restores a dictionary written by SaveDict
+  bool LoadDict(const std::string& path);
+  // Removes the words filtered out by options from the documents, posting
+  // lists and dictionary, and renumbers the remaining words compactly in
+  // their original order, so every nw x K model matrix shrinks with the
+  // vocabulary. Documents left empty are kept. Call it after loading and
+  // before Init.
+  bool Prune(const PruneOptions& options);
+  // Renumbers the words by descending corpus frequency, ties by the old id,
+  // rewriting documents, posting lists and the dictionary. Models index
+  // their parameter rows by word id, so this packs the rows of the
+  // frequent words together. Call it after loading and before Init.
+  void RemapByFrequency();
+  // Encodes the documents and posting lists into two contiguous arenas of
+  // delta + variable-byte entries and frees the plain entries. Doc and Post
+  // must not be used afterwards, so models read the entries through
+  // DocReader and PostReader, which work in both forms.
+  void Pack();
+  bool packed() const {
+    return packed_;
+  }
+  // bytes used by the entries of the documents and posting lists
+  std::size_t EntryBytes() const;
   const Document& Doc(uint32_t doc) const {
+    DCHECK(!packed_) << "Doc of a packed DocumentSet";
     return docs_[doc];
   }
   const PostingList& Post(uint32_t word) const {
+    DCHECK(!packed_) << "Post of a packed DocumentSet";
     return posts_[word];
   }
+  // number of distinct words in document doc
+  uint32_t DocLength(uint32_t doc) const {
+    return packed_ ? doc_pack_.lengths[doc] : docs_[doc].Size();
+  }
+  EntryReader DocReader(uint32_t doc) const {
+    return packed_ ? doc_pack_.Reader(doc) : docs_[doc].Reader();
+  }
+  EntryReader PostReader(uint32_t word) const {
+    return packed_ ? post_pack_.Reader(word) : posts_[word].Reader();
+  }
+  // Document::ToString of document doc, packed or not
+  std::string DocString(uint32_t doc) const {
+    EntryReader reader = DocReader(doc);
+    std::stringstream ss;
+    ss << reader.Size() << ":";
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      ss << " " << w << "/" << n;
+    }
+    return ss.str();
+  }
   std::size_t DocSize() const {
-    return docs_.size();
+    return packed_ ? doc_pack_.lengths.size() : docs_.size();
   }
   uint32_t DictSize() const {
     return word2idx_.size();
@@ -116,9 +275,9 @@ public:
   std::size_t TotalWordOccurs() const {
     if (woccurs_ > 0) return woccurs_;
     for (uint32_t d = 0; d < DocSize(); ++d) {
-      const Document& doc = Doc(d);
-      for (uint32_t p = 0; p < doc.Size(); ++p) {
-        woccurs_ += doc.Freq(p);
+      EntryReader reader = DocReader(d);
+      for (uint32_t w, n; reader.Next(&w, &n); ) {
+        woccurs_ += n;
       }
     }
     return woccurs_;
@@ -135,6 +294,13 @@ public:
     }
     return idx;
   }
+  // Looks word up without adding it to the dictionary
+  bool Find(const std::string& word, uint32_t* idx) const {
+    Word2Idx::const_iterator it = word2idx_.find(word);
+    if (it == word2idx_.end()) return false;
+    *idx = it->second;
+    return true;
+  }
   std::string Word(uint32_t idx) const {
     return words_[idx];
   }
@@ -146,6 +312,8 @@ public:
     word2idx_.clear();
     words_.clear();
     docs_.clear();
+    posts_.clear();
+    ClearPacked();
     woccurs_ = 0;
     idx2freq_done_ = false;
   }
@@ -153,16 +321,56 @@ protected:
   typedef std::map<std::string, uint32_t> Word2Idx;
   typedef std::map<std::size_t, std::size_t> Idx2Freq;
 
+  /**
+   * @brief Packed entry lists stored back to back
+   */
+  struct PackedLists {
+    std::vector<uint8_t> bytes;
+    std::vector<std::size_t> offsets;  // offsets[i]: first byte of list i
+    std::vector<uint32_t> lengths;     // lengths[i]: number of entries of list i
+    EntryReader Reader(uint32_t i) const {
+      return EntryReader(bytes.empty() ? NULL : &bytes[0] + offsets[i], lengths[i]);
+    }
+    template<typename List>
+    void Append(const List& list) {
+      offsets.push_back(bytes.size());
+      lengths.push_back(list.Size());
+      EntryReader reader = list.Reader();
+      uint32_t prev = 0;
+      for (uint32_t id, freq; reader.Next(&id, &freq); ) {
+        EntryReader::WriteVarint(id - prev, &bytes);
+        EntryReader::WriteVarint(freq, &bytes);
+        prev = id;
+      }
+    }
+    void Clear() {
+      std::vector<uint8_t>().swap(bytes);
+      std::vector<std::size_t>().swap(offsets);
+      std::vector<uint32_t>().swap(lengths);
+    }
+  };
+
   Word2Idx word2idx_;
   std::vector<std::string> words_;
   std::vector<Document> docs_;
   std::vector<PostingList> posts_;
+  bool packed_;
+  PackedLists doc_pack_;
+  PackedLists post_pack_;
   mutable std::size_t woccurs_;
 
   mutable Idx2Freq idx2freq_;
   mutable bool idx2freq_done_;
 
   bool CalcWordFreq() const;
+  // Renames every word w to ids[w] in [0, size), dropping the words mapped to Document::kNoWord
+  void Renumber(const std::vector<uint32_t>& ids, uint32_t size);
+  void ClearPacked() {
+    packed_ = false;
+    doc_pack_.Clear();
+    post_pack_.Clear();
+  }
+  void ParseDoc(const std::string& line, Document* doc);
 };
 
 } /* namespace toyml */
@@ -6,7 +6,361 @@
  */
 
 #include "dataset.h"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <gtest/gtest.h>
+
+#include <toyml/tm/plsa/plsa.h>
+#include <toyml/tm/lda/gibbs_lda.h>
 
 namespace toyml {
 
+namespace {
+
+typedef std::map<std::string, uint32_t> WordCounts;
+typedef std::vector<EntryReader::Entry> Entries;
+
+Entries ReadAll(EntryReader reader) {
+  Entries entries;
+  for (uint32_t id, freq; reader.Next(&id, &freq); ) {
+    entries.push_back(EntryReader::Entry(id, freq));
+  }
+  return entries;
+}
+
+std::vector<Entries> DocEntries(const DocumentSet& dataset) {
+  std::vector<Entries> docs(dataset.DocSize());
+  for (uint32_t d = 0; d < dataset.DocSize(); ++d) {
+    docs[d] = ReadAll(dataset.DocReader(d));
+  }
+  return docs;
+}
+
+std::vector<Entries> PostEntries(const DocumentSet& dataset) {
+  std::vector<Entries> posts(dataset.DictSize());
+  for (uint32_t w = 0; w < dataset.DictSize(); ++w) {
+    posts[w] = ReadAll(dataset.PostReader(w));
+  }
+  return posts;
+}
+
+// The words and frequencies of every document, independent of the word ids
+std::vector<WordCounts> Contents(const DocumentSet& dataset) {
+  std::vector<WordCounts> contents(dataset.DocSize());
+  for (uint32_t d = 0; d < dataset.DocSize(); ++d) {
+    EntryReader reader = dataset.DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      contents[d][dataset.Word(w)] = n;
+    }
+  }
+  return contents;
+}
+
+// Checks that the dictionary, the documents and the posting lists agree
+void ExpectConsistent(const DocumentSet& dataset) {
+  std::vector<std::map<uint32_t, uint32_t> > posts(dataset.DictSize());
+  for (uint32_t d = 0; d < dataset.DocSize(); ++d) {
+    EntryReader reader = dataset.DocReader(d);
+    EXPECT_EQ(dataset.DocLength(d), reader.Size());
+    uint32_t prev = 0;
+    for (uint32_t w, n, i = 0; reader.Next(&w, &n); ++i) {
+      ASSERT_LT(w, dataset.DictSize());
+      if (i > 0) {
+        EXPECT_LT(prev, w) << "d=" << d;
+      }
+      prev = w;
+      posts[w][d] = n;
+    }
+  }
+  for (uint32_t w = 0; w < dataset.DictSize(); ++w) {
+    uint32_t idx = 0;
+    EXPECT_TRUE(dataset.Find(dataset.Word(w), &idx));
+    EXPECT_EQ(w, idx);
+    std::map<uint32_t, uint32_t> post;
+    EntryReader reader = dataset.PostReader(w);
+    for (uint32_t d, n; reader.Next(&d, &n); ) {
+      post[d] = n;
+    }
+    EXPECT_EQ(posts[w], post) << "w=" << w;
+  }
+}
+
+/**
+ * @brief Takes documents with arbitrary word ids, without a dictionary
+ */
+class RawDocumentSet: public DocumentSet {
+public:
+  void AddDoc(const Document& doc) {
+    docs_.push_back(doc);
+  }
+};
+
+/**
+ * @brief Runs the EM steps of pLSA without saving the model
+ */
+class PLSARunner: public PLSA {
+public:
+  void Run(std::size_t iters) {
+    std::srand(0);
+    InitProb();
+    for (iter_ = 0; iter_ < iters; ++iter_) {
+      EMStep();
+    }
+  }
+};
+
+}  // namespace
+
+class DocumentSetTest: public testing::Test {
+protected:
+  DocumentSetTest(): path_("dataset_test.dat"), stopwords_("dataset_test.stop") {}
+  virtual void TearDown() {
+    std::remove(path_.c_str());
+    std::remove(stopwords_.c_str());
+  }
+  // Loads the documents of text, one per line, with their posting lists
+  bool Load(const std::string& text, DocumentSet* dataset) {
+    {
+      std::ofstream outf(path_.c_str());
+      outf << text;
+    }
+    return dataset->Load(path_);
+  }
+  // Prunes kPruneCorpus with options and checks that exactly the
+  // space separated words of expected remain, with ids in their original order
+  void ExpectPruned(const PruneOptions& options, const std::string& expected) {
+    SCOPED_TRACE(options.ToString());
+    DocumentSet dataset;
+    ASSERT_TRUE(Load(kPruneCorpus, &dataset));
+    std::vector<WordCounts> contents = Contents(dataset);
+    ASSERT_TRUE(dataset.Prune(options));
+
+    std::vector<std::string> words;
+    std::istringstream iss(expected);
+    for (std::string word; iss >> word; ) {
+      words.push_back(word);
+    }
+    ASSERT_EQ(words.size(), dataset.DictSize());
+    for (uint32_t w = 0; w < dataset.DictSize(); ++w) {
+      EXPECT_EQ(words[w], dataset.Word(w));
+    }
+    std::set<std::string> kept(words.begin(), words.end());
+    for (std::size_t d = 0; d < contents.size(); ++d) {
+      for (WordCounts::iterator it = contents[d].begin(); it != contents[d].end(); ) {
+        if (kept.count(it->first)) {
+          ++it;
+        } else {
+          contents[d].erase(it++);
+        }
+      }
+    }
+    EXPECT_EQ(contents, Contents(dataset));
+    ExpectConsistent(dataset);
+  }
+
+  static const char* kPruneCorpus;
+  static const char* kModelCorpus;
+  std::string path_;
+  std::string stopwords_;
+};
+
+// document frequencies: the 4, apple 3, cherry 3, others 1
+// corpus frequencies: the 4, apple 4, cherry 3, others 1
+const char* DocumentSetTest::kPruneCorpus =
+    "the apple banana apple\n"
+    "the cherry apple\n"
+    "the cherry date egg\n"
+    "the apple cherry fig\n";
+
+// one empty document, and words spread over the documents so the posting
+// lists have different lengths
+const char* DocumentSetTest::kModelCorpus =
+    "apple banana apple cherry w0 w1 w2 w3 w4 w5 w6 w7 w8 w9\n"
+    "\n"
+    "dog eel fox dog eel w10 w11 w12 w13 w14 w15 w16 w17 w18 w19\n"
+    "apple dog cherry fox w20 w21 w22 w23 w24 w25 w26 w27 w28 w29\n";
+
+TEST_F(DocumentSetTest, RemapByFrequency) {
+  DocumentSet dataset;
+  ASSERT_TRUE(Load("apple banana apple cherry\ncherry cherry date\napple cherry\n", &dataset));
+  std::vector<WordCounts> contents = Contents(dataset);
+  dataset.RemapByFrequency();
+
+  // cherry 4, apple 3, then banana and date once each in their old order
+  const char* expected[] = {"cherry", "apple", "banana", "date"};
+  ASSERT_EQ(4u, dataset.DictSize());
+  for (uint32_t w = 0; w < dataset.DictSize(); ++w) {
+    EXPECT_EQ(expected[w], dataset.Word(w));
+  }
+  std::vector<std::size_t> freqs(dataset.DictSize(), 0);
+  for (uint32_t d = 0; d < dataset.DocSize(); ++d) {
+    EntryReader reader = dataset.DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      freqs[w] += n;
+    }
+  }
+  for (uint32_t w = 1; w < dataset.DictSize(); ++w) {
+    EXPECT_GE(freqs[w - 1], freqs[w]) << "w=" << w;
+  }
+  EXPECT_EQ(contents, Contents(dataset));
+  ExpectConsistent(dataset);
+}
+
+TEST_F(DocumentSetTest, Prune) {
+  PruneOptions options;
+  EXPECT_FALSE(options.Enabled());
+  ExpectPruned(options, "the apple banana cherry date egg fig");
+
+  options.min_df = 2;
+  ExpectPruned(options, "the apple cherry");
+
+  options = PruneOptions();
+  options.max_df = 0.75;
+  ExpectPruned(options, "apple banana cherry date egg fig");
+
+  options = PruneOptions();
+  options.max_words = 3;
+  ExpectPruned(options, "the apple cherry");
+
+  {
+    std::ofstream outf(stopwords_.c_str());
+    outf << "the\nfig\n";
+  }
+  options = PruneOptions();
+  options.stopwords = stopwords_;
+  ExpectPruned(options, "apple banana cherry date egg");
+
+  // the third document is left empty but kept
+  {
+    std::ofstream outf(stopwords_.c_str());
+    outf << "cherry\n";
+  }
+  options.min_df = 2;
+  options.max_df = 0.75;
+  ExpectPruned(options, "apple");
+  DocumentSet dataset;
+  ASSERT_TRUE(Load(kPruneCorpus, &dataset));
+  ASSERT_TRUE(dataset.Prune(options));
+  EXPECT_EQ(4u, dataset.DocSize());
+  EXPECT_EQ(0u, dataset.DocLength(2));
+
+  options.stopwords = "no_such_file";
+  EXPECT_FALSE(dataset.Prune(options));
+}
+
+TEST(DocumentSet, PackLargeIds) {
+  // ids and frequencies around the 1 to 5 byte boundaries of the varints
+  const uint32_t values[] = {0, 1, 127, 128, 16383, 16384, (1u << 21) - 1, 1u << 21,
+      (1u << 28) - 1, 1u << 28, 0xFFFFFFFEu, 0xFFFFFFFFu};
+  const std::size_t nvalues = sizeof(values) / sizeof(values[0]);
+  RawDocumentSet dataset;
+  Document doc;
+  for (std::size_t i = 0; i < nvalues; ++i) {
+    doc.Add(values[i], values[nvalues - 1 - i]);
+  }
+  dataset.AddDoc(doc);
+  // a first delta of 4 and 5 bytes
+  Document big;
+  big.Add(1u << 21, 1);
+  big.Add(1u << 28, 1u << 28);
+  dataset.AddDoc(big);
+  Document last;
+  last.Add(0xFFFFFFFFu, 0xFFFFFFFFu);
+  dataset.AddDoc(last);
+  dataset.AddDoc(Document());
+
+  std::vector<Entries> expected = DocEntries(dataset);
+  ASSERT_EQ(nvalues, expected[0].size());
+  dataset.Pack();
+  ASSERT_TRUE(dataset.packed());
+  EXPECT_EQ(expected, DocEntries(dataset));
+  for (uint32_t d = 0; d < dataset.DocSize(); ++d) {
+    EXPECT_EQ(expected[d].size(), dataset.DocLength(d));
+  }
+}
+
+TEST_F(DocumentSetTest, PackEmptyDocuments) {
+  DocumentSet dataset;
+  ASSERT_TRUE(Load(kModelCorpus, &dataset));
+  ASSERT_EQ(4u, dataset.DocSize());
+  EXPECT_EQ(0u, dataset.DocLength(1));
+  std::stringstream plain;
+  ASSERT_TRUE(dataset.WriteBinary(plain));
+  std::vector<Entries> docs = DocEntries(dataset);
+
+  dataset.Pack();
+  ASSERT_EQ(4u, dataset.DocSize());
+  EXPECT_EQ(0u, dataset.DocLength(1));
+  EXPECT_TRUE(ReadAll(dataset.DocReader(1)).empty());
+  EXPECT_EQ(docs, DocEntries(dataset));
+  std::stringstream packed;
+  ASSERT_TRUE(dataset.WriteBinary(packed));
+  EXPECT_EQ(plain.str(), packed.str());
+
+  // and the binary documents read back, empty ones included
+  DocumentSet binary;
+  EXPECT_EQ(4u, binary.LoadNextBinary(packed, 100));
+  EXPECT_EQ(docs, DocEntries(binary));
+}
+
+TEST_F(DocumentSetTest, PackPostingLists) {
+  DocumentSet dataset;
+  ASSERT_TRUE(Load(kModelCorpus, &dataset));
+  std::vector<Entries> docs = DocEntries(dataset);
+  std::vector<Entries> posts = PostEntries(dataset);
+  std::size_t bytes = dataset.EntryBytes();
+  dataset.Pack();
+  EXPECT_EQ(docs, DocEntries(dataset));
+  EXPECT_EQ(posts, PostEntries(dataset));
+  EXPECT_LT(dataset.EntryBytes(), bytes);
+  ExpectConsistent(dataset);
+}
+
+TEST_F(DocumentSetTest, PackedModelsMatch) {
+  DocumentSet plain, packed;
+  ASSERT_TRUE(Load(kModelCorpus, &plain));
+  ASSERT_TRUE(Load(kModelCorpus, &packed));
+  packed.Pack();
+
+  PLSAOptions options;
+  options.ntopics = 3;
+  PLSARunner plsa, packed_plsa;
+  ASSERT_TRUE(plsa.Init(options, plain));
+  ASSERT_TRUE(packed_plsa.Init(options, packed));
+  plsa.Run(5);
+  packed_plsa.Run(5);
+  ASSERT_EQ(plsa.p_w_z().size1(), packed_plsa.p_w_z().size1());
+  for (uint32_t w = 0; w < plain.DictSize(); ++w) {
+    for (uint32_t z = 0; z < options.ntopics; ++z) {
+      EXPECT_EQ(plsa.p_w_z()(w, z), packed_plsa.p_w_z()(w, z)) << NVC_(w) << NV_(z);
+    }
+  }
+
+  LDAOptions lda_options;
+  lda_options.topics = 3;
+  // Init reseeds std::rand, so the models are run one after the other
+  GibbsLDA lda, packed_lda;
+  ASSERT_TRUE(lda.Init(lda_options, plain));
+  for (int i = 0; i < 5; ++i) {
+    lda.Sweep();
+  }
+  ASSERT_TRUE(packed_lda.Init(lda_options, packed));
+  for (int i = 0; i < 5; ++i) {
+    packed_lda.Sweep();
+  }
+  EXPECT_EQ(lda.LogLikelihood(), packed_lda.LogLikelihood());
+  ublas::matrix<double> p_w_z, packed_p_w_z;
+  lda.TopicWordProb(&p_w_z);
+  packed_lda.TopicWordProb(&packed_p_w_z);
+  ASSERT_EQ(p_w_z.size1(), packed_p_w_z.size1());
+  ASSERT_EQ(p_w_z.size2(), packed_p_w_z.size2());
+  for (std::size_t w = 0; w < p_w_z.size1(); ++w) {
+    for (std::size_t z = 0; z < p_w_z.size2(); ++z) {
+      EXPECT_EQ(p_w_z(w, z), packed_p_w_z(w, z)) << NVC_(w) << NV_(z);
+    }
+  }
+}
+
 } /* namespace toyml */
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "heldout.h"
+
+#include <omp.h>
+#include <cmath>
+#include <limits>
+#include <iomanip>
+#include <boost/bind.hpp>
+#include <glog/logging.h>
+
+namespace toyml {
+
+HeldoutEvaluator::HeldoutEvaluator() :
+    nd_(0), nw_(0), nobserved_(0), ntest_(0), nunknown_(0), running_(false), snapshot_iter_(0),
+    last_perplexity_(0) {
+}
+
+HeldoutEvaluator::~HeldoutEvaluator() {
+  Wait();
+}
+
+bool HeldoutEvaluator::Init(const HeldoutOptions& options, const DocumentSet& train,
+    const DocumentSet& heldout) {
+  Wait();
+  options_ = options;
+  nd_ = heldout.DocSize();
+  nw_ = train.DictSize();
+  nobserved_ = ntest_ = nunknown_ = 0;
+
+  // held-out word id -> training word id, or Document::kNoWord
+  std::vector<uint32_t> ids(heldout.DictSize(), Document::kNoWord);
+  for (uint32_t w = 0; w < ids.size(); ++w) {
+    train.Find(heldout.Word(w), &ids[w]);
+  }
+
+  offsets_.assign(1, 0);
+  splits_.clear();
+  words_.clear();
+  freqs_.clear();
+  std::vector<uint32_t> test_words, test_freqs;
+  std::size_t nknown = 0;
+  for (std::size_t d = 0; d < nd_; ++d) {
+    test_words.clear();
+    test_freqs.clear();
+    EntryReader reader = heldout.DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      if (ids[w] == Document::kNoWord) {
+        nunknown_ += n;
+        continue;
+      }
+      if (nknown++ % 2 == 0) {
+        words_.push_back(ids[w]);
+        freqs_.push_back(n);
+        nobserved_ += n;
+      } else {
+        test_words.push_back(ids[w]);
+        test_freqs.push_back(n);
+        ntest_ += n;
+      }
+    }
+    splits_.push_back(words_.size());
+    words_.insert(words_.end(), test_words.begin(), test_words.end());
+    freqs_.insert(freqs_.end(), test_freqs.begin(), test_freqs.end());
+    offsets_.push_back(words_.size());
+    nknown = 0;
+  }
+  if (ntest_ == 0) {
+    LOG(ERROR) << "No held-out word to evaluate: " << ToString();
+    return false;
+  }
+  return true;
+}
+
+double HeldoutEvaluator::DocLogLikelihood(std::size_t d, const ublas::matrix<double>& p_w_z,
+    double* theta, double* acc) const {
+  const std::size_t nz = p_w_z.size2();
+  const double* phi = &p_w_z.data()[0];
+  const double floor = std::numeric_limits<double>::min();
+
+  for (std::size_t z = 0; z < nz; ++z) {
+    theta[z] = 1.0 / nz;
+  }
+  for (std::size_t iter = 0; iter < options_.fold_in_iters && splits_[d] > offsets_[d]; ++iter) {
+    for (std::size_t z = 0; z < nz; ++z) {
+      acc[z] = 0;
+    }
+    double total = 0;
+    for (std::size_t i = offsets_[d]; i < splits_[d]; ++i) {
+      const double* row = phi + words_[i] * nz;
+      double p = 0;
+#pragma omp simd reduction(+: p)
+      for (std::size_t z = 0; z < nz; ++z) {
+        p += theta[z] * row[z];
+      }
+      double coef = freqs_[i] / std::max(p, floor);
+#pragma omp simd
+      for (std::size_t z = 0; z < nz; ++z) {
+        acc[z] += coef * row[z];
+      }
+      total += freqs_[i];
+    }
+    // theta[z] * acc[z] is the expected count of topic z on the observed words
+    double norm = total + nz * options_.alpha;
+#pragma omp simd
+    for (std::size_t z = 0; z < nz; ++z) {
+      theta[z] = (theta[z] * acc[z] + options_.alpha) / norm;
+    }
+  }
+
+  double lik = 0;
+  for (std::size_t i = splits_[d]; i < offsets_[d + 1]; ++i) {
+    const double* row = phi + words_[i] * nz;
+    double p = 0;
+#pragma omp simd reduction(+: p)
+    for (std::size_t z = 0; z < nz; ++z) {
+      p += theta[z] * row[z];
+    }
+    lik += freqs_[i] * std::log(std::max(p, floor));
+  }
+  return lik;
+}
+
+double HeldoutEvaluator::Perplexity(const ublas::matrix<double>& p_w_z) const {
+  CHECK_EQ(p_w_z.size1(), nw_) << "p(w|z) does not match the training vocabulary";
+  const std::size_t nz = p_w_z.size2();
+  std::size_t nthreads = options_.threads ? options_.threads : omp_get_max_threads();
+  double lik = 0;
+#pragma omp parallel num_threads(nthreads) reduction(+: lik)
+  {
+    std::vector<double> theta(nz), acc(nz);
+#pragma omp for schedule(dynamic, 64)
+    for (std::size_t d = 0; d < nd_; ++d) {
+      lik += DocLogLikelihood(d, p_w_z, &theta[0], &acc[0]);
+    }
+  }
+  return ntest_ > 0 ? std::exp(-lik / ntest_) : 0;
+}
+
+bool HeldoutEvaluator::EvaluateAsync(const ublas::matrix<double>& p_w_z, std::size_t iter) {
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    if (running_) {
+      VLOG(1) << "Skipped held-out evaluation of iteration#" << iter << ", the previous one is running";
+      return false;
+    }
+    running_ = true;
+  }
+  thread_.join();
+  snapshot_ = p_w_z;
+  snapshot_iter_ = iter;
+  thread_ = boost::thread(boost::bind(&HeldoutEvaluator::Run, this));
+  return true;
+}
+
+double HeldoutEvaluator::Wait() {
+  thread_.join();
+  return last_perplexity_;
+}
+
+void HeldoutEvaluator::Run() {
+  double ppx = Perplexity(snapshot_);
+  VLOG(0) << "Iteration#" << snapshot_iter_ << " held-out perplexity=" << std::setprecision(10) << ppx;
+  boost::mutex::scoped_lock lock(mutex_);
+  last_perplexity_ = ppx;
+  running_ = false;
+}
+
+} /* namespace toyml */
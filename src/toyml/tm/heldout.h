@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef HELDOUT_H_
+#define HELDOUT_H_
+
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/thread.hpp>
+
+#include <toyml/tm/utils.h>
+#include <toyml/tm/dataset.h>
+
+namespace toyml {
+
+namespace ublas = boost::numeric::ublas;
+
+/**
+ * @brief Held-out evaluation options
+ */
+struct HeldoutOptions {
+  std::size_t fold_in_iters;  // EM iterations estimating p(z|d) on the observed half of a document
+  double alpha;               // pseudo count added to every topic of p(z|d), 0 means pLSA fold-in
+  std::size_t threads;        // 0 means using all the cores
+  HeldoutOptions() :
+      fold_in_iters(20), alpha(0), threads(0) {
+  }
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << NVC_(fold_in_iters) << NVC_(alpha) << NV_(threads);
+    return ss.str();
+  }
+};
+
+/**
+ * @brief Held-out perplexity of a topic model by document completion
+ *
+ * The distinct words of every held-out document are split alternately into
+ * an observed half and a test half. p(z|d) is folded in on the observed half
+ * by EM with p(w|z) fixed, and the perplexity is computed on the test half.
+ * Documents are evaluated in parallel. EvaluateAsync runs on a background
+ * thread on a copy of p(w|z), so a training loop can call it periodically
+ * without waiting for the result.
+ */
+class HeldoutEvaluator {
+public:
+  HeldoutEvaluator();
+  virtual ~HeldoutEvaluator();
+
+  // Maps the words of heldout into the vocabulary of train; words unknown
+  // to train are dropped
+  bool Init(const HeldoutOptions& options, const DocumentSet& train, const DocumentSet& heldout);
+  // p_w_z is the nw x nz matrix of p(w|z) over the vocabulary of train
+  double Perplexity(const ublas::matrix<double>& p_w_z) const;
+  // Starts evaluating a copy of p_w_z on a background thread and logs the
+  // result with iter. Returns false without copying if the previous
+  // evaluation is still running.
+  bool EvaluateAsync(const ublas::matrix<double>& p_w_z, std::size_t iter);
+  // Waits for the background evaluation and returns its perplexity, or 0 if none was started
+  double Wait();
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << NVC_(nd_) << NVC_(nobserved_) << NVC_(ntest_) << NV_(nunknown_);
+    return ss.str();
+  }
+private:
+  HeldoutOptions options_;
+  std::size_t nd_;
+  std::size_t nw_;
+  std::size_t nobserved_;  // tokens of the observed halves
+  std::size_t ntest_;      // tokens of the test halves
+  std::size_t nunknown_;   // tokens dropped as unknown to the training vocabulary
+
+  // entries of document d are [offsets_[d], offsets_[d + 1]), the first
+  // splits_[d] of them observed and the rest tested
+  std::vector<std::size_t> offsets_;
+  std::vector<std::size_t> splits_;
+  std::vector<uint32_t> words_;
+  std::vector<uint32_t> freqs_;
+
+  boost::thread thread_;
+  boost::mutex mutex_;
+  bool running_;
+  ublas::matrix<double> snapshot_;
+  std::size_t snapshot_iter_;
+  double last_perplexity_;
+
+  // Folds p(z|d) in on the observed entries of d and returns the log-likelihood of its test entries
+  double DocLogLikelihood(std::size_t d, const ublas::matrix<double>& p_w_z,
+      double* theta, double* acc) const;
+  void Run();
+};
+
+} /* namespace toyml */
+#endif /* HELDOUT_H_ */
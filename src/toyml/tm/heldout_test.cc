@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "heldout.h"
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+namespace {
+
+void LoadText(const std::string& text, DocumentSet* dataset) {
+  std::stringstream ss(text);
+  dataset->LoadNext(ss, 100);
+}
+
+}  // namespace
+
+TEST(HeldoutEvaluator, UniformPerplexityIsVocabularySize) {
+  DocumentSet train, heldout;
+  LoadText("a b c d e\na a b\n", &train);
+  LoadText("a b c d\nb c e e\n", &heldout);
+  HeldoutOptions options;
+  options.threads = 1;
+  HeldoutEvaluator evaluator;
+  ASSERT_TRUE(evaluator.Init(options, train, heldout));
+
+  // p(w|d) = 1 / 5 whatever p(z|d) is folded in
+  const std::size_t nw = train.DictSize(), nz = 3;
+  ublas::matrix<double> p_w_z(nw, nz);
+  for (std::size_t w = 0; w < nw; ++w) {
+    for (std::size_t z = 0; z < nz; ++z) {
+      p_w_z(w, z) = 1.0 / nw;
+    }
+  }
+  EXPECT_NEAR(5.0, evaluator.Perplexity(p_w_z), 1e-12);
+
+  options.alpha = 0.5;
+  ASSERT_TRUE(evaluator.Init(options, train, heldout));
+  EXPECT_NEAR(5.0, evaluator.Perplexity(p_w_z), 1e-12);
+  ASSERT_TRUE(evaluator.EvaluateAsync(p_w_z, 1));
+  EXPECT_NEAR(5.0, evaluator.Wait(), 1e-12);
+}
+
+TEST(HeldoutEvaluator, DropsUnknownWords) {
+  DocumentSet train, heldout, noisy;
+  LoadText("a b c d e\na a b\n", &train);
+  LoadText("a b c d\nb c e e\n", &heldout);
+  // x, y and z are not in the training vocabulary; the known words keep their order
+  LoadText("a x b y c d x\nz b c e e\n", &noisy);
+
+  const std::size_t nw = train.DictSize(), nz = 3;
+  ublas::matrix<double> p_w_z(nw, nz);
+  for (std::size_t z = 0; z < nz; ++z) {
+    double sum = 0;
+    for (std::size_t w = 0; w < nw; ++w) {
+      p_w_z(w, z) = 1 + (w * nz + z) % 4;
+      sum += p_w_z(w, z);
+    }
+    for (std::size_t w = 0; w < nw; ++w) {
+      p_w_z(w, z) /= sum;
+    }
+  }
+
+  HeldoutOptions options;
+  options.threads = 1;
+  HeldoutEvaluator expected, actual;
+  ASSERT_TRUE(expected.Init(options, train, heldout));
+  ASSERT_TRUE(actual.Init(options, train, noisy));
+  EXPECT_EQ("nd_=2, nobserved_=5, ntest_=3, nunknown_=0", expected.ToString());
+  EXPECT_EQ("nd_=2, nobserved_=5, ntest_=3, nunknown_=4", actual.ToString());
+  EXPECT_DOUBLE_EQ(expected.Perplexity(p_w_z), actual.Perplexity(p_w_z));
+
+  // nothing is left to test
+  DocumentSet unknown;
+  LoadText("x y z\n", &unknown);
+  EXPECT_FALSE(actual.Init(options, train, unknown));
+}
+
+} /* namespace toyml */
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "cvb0_lda.h"
+#include <omp.h>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <glog/logging.h>
+
+namespace toyml {
+
+CVB0LDA::CVB0LDA() :
+    evaluator_(NULL), eval_interval_(0) {
+}
+
+CVB0LDA::~CVB0LDA() {
+}
+
+bool CVB0LDA::Init(const LDAOptions& options, const DocumentSet& dataset) {
+  options_ = options;
+  dataset_ = &dataset;
+  Initialize();
+  return true;
+}
+
+std::size_t CVB0LDA::Train() {
+  SaveModel(0);
+  double pre_ppx = Perplexity();
+  VLOG(0) << "[begin] perplexity=" << std::setprecision(10) << pre_ppx;
+  for (iter_ = 1; iter_ <= options_.iters; ++iter_) {
+    VLOG_EVERY_N(0, options_.nlog) << "Iteration#" << iter_;
+    Sweep();
+    if (iter_ % options_.nsave == 0) {
+      SaveModel(iter_);
+    }
+    if (evaluator_ && eval_interval_ > 0 && iter_ % eval_interval_ == 0) {
+      TopicWordProb(&eval_p_w_z_);
+      evaluator_->EvaluateAsync(eval_p_w_z_, iter_);
+    }
+    if (iter_ % options_.nlog == 0) {
+      double cur_ppx = Perplexity();
+      VLOG(0) << "Iteration#" << iter_ << " perplexity=" << std::setprecision(10) << cur_ppx;
+      if (pre_ppx - cur_ppx < options_.eps * pre_ppx) {
+        VLOG(0) << "[break] Iteration#" << iter_ << " perplexity=" << cur_ppx << ", eps=" << options_.eps;
+        break;
+      }
+      pre_ppx = cur_ppx;
+    }
+  }
+  VLOG(0) << "[end]";
+  if (evaluator_) {
+    evaluator_->Wait();
+    TopicWordProb(&eval_p_w_z_);
+    VLOG(0) << "[end] held-out perplexity=" << std::setprecision(10) << evaluator_->Perplexity(eval_p_w_z_);
+  }
+  SaveModel(options_.finalsuffix);
+  return std::min(iter_, options_.iters);
+}
+
+void CVB0LDA::Initialize() {
+  if (options_.random) {
+    std::srand(std::time(NULL));
+  } else {
+    std::srand(0);
+  }
+
+  nd_ = dataset_->DocSize();
+  nw_ = dataset_->DictSize();
+  nz_ = options_.topics;
+  nthreads_ = options_.threads ? options_.threads : omp_get_max_threads();
+
+  alpha_ = options_.alpha / nz_;
+  beta_ = options_.beta;
+  kalpha_ = nz_ * alpha_;
+  vbeta_ = nw_ * beta_;
+
+  n_dz_ = ublas::matrix<float>(nd_, nz_, 0);
+  n_wz_ = ublas::matrix<float>(nw_, nz_, 0);
+  n_d_ = ublas::vector<float>(nd_, 0);
+  n_z_ = ublas::vector<float>(nz_, 0);
+
+  offsets_.resize(nd_ + 1);
+  offsets_[0] = 0;
+  for (std::size_t d = 0; d < nd_; ++d) {
+    offsets_[d + 1] = offsets_[d] + dataset_->DocLength(d);
+  }
+  gamma_.resize(offsets_[nd_] * nz_);
+
+  for (std::size_t d = 0; d < nd_; ++d) {
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t wi = 0, w, freq; reader.Next(&w, &freq); ++wi) {
+      float n = freq;
+      float* gamma = &gamma_[(offsets_[d] + wi) * nz_];
+      float norm = 0;
+      for (std::size_t z = 0; z < nz_; ++z) {
+        gamma[z] = static_cast<float>(std::rand()) / RAND_MAX + 1e-3f;
+        norm += gamma[z];
+      }
+      for (std::size_t z = 0; z < nz_; ++z) {
+        gamma[z] /= norm;
+        n_dz_(d, z) += n * gamma[z];
+        n_wz_(w, z) += n * gamma[z];
+        n_z_(z) += n * gamma[z];
+      }
+      n_d_(d) += n;
+    }
+  }
+
+  n_wz_new_vec_.resize(nthreads_, ublas::matrix<float>(nw_, nz_));
+  n_z_new_vec_.resize(nthreads_, ublas::vector<float>(nz_));
+
+  theta_.resize(nd_, nz_);
+  phi_.resize(nz_, nw_);
+}
+
+void CVB0LDA::Sweep() {
+  // Each thread owns a static block of documents, so a sweep gives the same
+  // result on every run with the same number of threads.
+  // The runtime may start fewer threads than asked for
+  std::size_t nused = 0;
+#pragma omp parallel num_threads(nthreads_)
+  {
+#pragma omp single
+    nused = omp_get_num_threads();
+    std::size_t tid = omp_get_thread_num();
+    ublas::matrix<float>& n_wz_new = n_wz_new_vec_[tid];
+    ublas::vector<float>& n_z_new = n_z_new_vec_[tid];
+    n_wz_new.clear();
+    n_z_new.clear();
+    std::vector<float> q(nz_);
+
+#pragma omp for schedule(static)
+    for (std::size_t d = 0; d < nd_; ++d) {
+      EntryReader reader = dataset_->DocReader(d);
+      for (uint32_t wi = 0, w, freq; reader.Next(&w, &freq); ++wi) {
+        float n = freq;
+        float* gamma = &gamma_[(offsets_[d] + wi) * nz_];
+        float norm = 0;
+        for (std::size_t z = 0; z < nz_; ++z) {
+          float own = n * gamma[z];
+          float p = (n_wz_(w, z) - own + beta_) * (n_dz_(d, z) - own + alpha_) /
+              (n_z_(z) - own + vbeta_);
+          q[z] = std::max(p, 0.0f);
+          norm += q[z];
+        }
+        for (std::size_t z = 0; z < nz_; ++z) {
+          float g = q[z] / norm;
+          n_dz_(d, z) += n * (g - gamma[z]);
+          gamma[z] = g;
+          n_wz_new(w, z) += n * g;
+          n_z_new(z) += n * g;
+        }
+      }
+    }
+  }
+
+#pragma omp parallel for num_threads(nthreads_)
+  for (std::size_t w = 0; w < nw_; ++w) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      float sum = 0;
+      for (std::size_t tid = 0; tid < nused; ++tid) {
+        sum += n_wz_new_vec_[tid](w, z);
+      }
+      n_wz_(w, z) = sum;
+    }
+  }
+  for (std::size_t z = 0; z < nz_; ++z) {
+    float sum = 0;
+    for (std::size_t tid = 0; tid < nused; ++tid) {
+      sum += n_z_new_vec_[tid](z);
+    }
+    n_z_(z) = sum;
+  }
+}
+
+double CVB0LDA::Perplexity() const {
+  double lik = 0;
+  double nwords = 0;
+#pragma omp parallel for num_threads(nthreads_) reduction(+: lik, nwords)
+  for (std::size_t d = 0; d < nd_; ++d) {
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      double p_dw = 0;
+      for (std::size_t z = 0; z < nz_; ++z) {
+        p_dw += (n_wz_(w, z) + beta_) / (n_z_(z) + vbeta_) *
+            (n_dz_(d, z) + alpha_) / (n_d_(d) + kalpha_);
+      }
+      lik += n * log(p_dw);
+      nwords += n;
+    }
+  }
+  return nwords > 0 ? exp(-lik / nwords) : 0;
+}
+
+void CVB0LDA::TopicWordProb(ublas::matrix<double>* p_w_z) const {
+  p_w_z->resize(nw_, nz_, false);
+  for (std::size_t w = 0; w < nw_; ++w) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      (*p_w_z)(w, z) = (n_wz_(w, z) + beta_) / (n_z_(z) + vbeta_);
+    }
+  }
+}
+
+std::string CVB0LDA::ToString() const {
+  std::stringstream ss;
+  ss << NVC_(nd_) << NVC_(nz_) << NVC_(nw_) << NVC_(nthreads_) << NVC_(alpha_) << NV_(beta_);
+  return ss.str();
+}
+
+void CVB0LDA::CalcThetaPhi() {
+  for (std::size_t d = 0; d < nd_; ++d) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      theta_(d, z) = (n_dz_(d, z) + alpha_) / (n_d_(d) + kalpha_);
+    }
+  }
+  for (std::size_t z = 0; z < nz_; ++z) {
+    for (std::size_t w = 0; w < nw_; ++w) {
+      phi_(z, w) = (n_wz_(w, z) + beta_) / (n_z_(z) + vbeta_);
+    }
+  }
+}
+
+bool CVB0LDA::SaveModel(int no) {
+  std::stringstream ss;
+  ss << no;
+  return SaveModel(ss.str());
+}
+
+bool CVB0LDA::SaveModel(const std::string& suffix) {
+  VLOG(0) << "SaveModel suffix=" << suffix;
+  CalcThetaPhi();
+  bool ret = SaveTopics(Path(options_.zpath, suffix));
+  ret &= Utils::SaveMatrix(phi_, Path(options_.zwpath, suffix));
+  ret &= Utils::SaveMatrix(theta_, Path(options_.dzpath, suffix));
+  return ret;
+}
+
+bool CVB0LDA::SaveTopics(const std::string& path) const {
+  std::ofstream outf(path.c_str());
+  if (!outf) {
+    LOG(ERROR) << "Failed to save topics to " << path;
+    return false;
+  }
+
+  std::vector<std::vector<Utils::ProbId> > tops;
+  Utils::TopK(phi_, false, options_.topn, &tops);
+  for (std::size_t z = 0; z < nz_; ++z) {
+    const std::vector<Utils::ProbId>& vec = tops[z];
+    outf << "Topic #" << z << ":\n";
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+      outf << "\t" << dataset_->Word(vec[i].second) << "\t" << vec[i].first << "\n";
+    }
+  }
+
+  outf.close();
+  VLOG(2) << "Saved topics to " << path;
+  return true;
+}
+
+std::string CVB0LDA::Path(const std::string& fname, const std::string& suffix) const {
+  if (suffix.length() == 0) {
+    return options_.datadir + "/" + fname;
+  } else {
+    return options_.datadir + "/" + fname + "." + suffix;
+  }
+}
+
+} /* namespace toyml */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef CVB0_LDA_H_
+#define CVB0_LDA_H_
+
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "lda.h"
+#include <toyml/tm/heldout.h>
+
+namespace toyml {
+
+namespace ublas = boost::numeric::ublas;
+
+/**
+ * @brief LDA using zero-order Collapsed Variational Bayes (CVB0)
+ *
+ * Every (document, word) entry keeps a topic distribution gamma instead of a
+ * sampled topic, so a sweep is deterministic. Documents are updated in
+ * parallel against the topic-word counts of the previous sweep, and the new
+ * counts are accumulated per thread and merged at the end of the sweep.
+ */
+class CVB0LDA {
+public:
+  CVB0LDA();
+  virtual ~CVB0LDA();
+
+  bool Init(const LDAOptions& options, const DocumentSet& dataset);
+  // Evaluates p(w|z) on evaluator in the background every interval sweeps of Train
+  void set_evaluator(HeldoutEvaluator* evaluator, std::size_t interval) {
+    evaluator_ = evaluator;
+    eval_interval_ = interval;
+  }
+  std::size_t Train();
+  void Sweep();
+  double Perplexity() const;
+  std::string ToString() const;
+  // p_w_z(w, z) = p(w|z), the nw x nz layout of HeldoutEvaluator
+  void TopicWordProb(ublas::matrix<double>* p_w_z) const;
+
+  bool SaveModel(int no);
+  bool SaveModel(const std::string& suffix = "");
+  bool SaveTopics(const std::string& path) const;
+private:
+  LDAOptions options_;
+  const DocumentSet* dataset_;
+
+  std::size_t nd_;  // number of documents
+  std::size_t nw_;  // size of vocabulary
+  std::size_t nz_;  // number of topics
+  std::size_t nthreads_;
+
+  float alpha_;
+  float beta_;
+  float kalpha_;
+  float vbeta_;
+
+  ublas::matrix<float> n_dz_;   // n_dz_(d, z): expected count of words in document d assigned to topic z
+  ublas::matrix<float> n_wz_;   // n_wz_(w, z): expected count of word w assigned to topic z
+  ublas::vector<float> n_d_;    // n_d_(d): count of words in document d
+  ublas::vector<float> n_z_;    // n_z_(z): expected count of words assigned to topic z
+
+  std::vector<std::size_t> offsets_;  // offsets_[d]: index of the first entry of document d
+  std::vector<float> gamma_;          // gamma_[(offsets_[d] + wi) * nz_ + z]: q(z) of entry wi in document d
+
+  std::vector<ublas::matrix<float> > n_wz_new_vec_;
+  std::vector<ublas::vector<float> > n_z_new_vec_;
+
+  ublas::matrix<double> theta_;   // document-topic distributions
+  ublas::matrix<double> phi_;     // topic-word distributions
+
+  std::size_t iter_;    // current iteration
+
+  HeldoutEvaluator* evaluator_;
+  std::size_t eval_interval_;
+  ublas::matrix<double> eval_p_w_z_;
+
+  void Initialize();
+  void CalcThetaPhi();
+  std::string Path(const std::string& fname, const std::string& suffix) const;
+};
+
+} /* namespace toyml */
+#endif /* CVB0_LDA_H_ */
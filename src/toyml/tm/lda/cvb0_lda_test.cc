@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "cvb0_lda.h"
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+TEST(CVB0LDA, PerplexityDecreases) {
+  std::stringstream ss;
+  for (int i = 0; i < 20; ++i) {
+    ss << "apple banana cherry apple banana date\n";
+    ss << "dog eel fox dog eel goat\n";
+  }
+  DocumentSet dataset;
+  ASSERT_EQ(40U, dataset.LoadNext(ss, 100));
+
+  LDAOptions options;
+  options.topics = 2;
+  options.alpha = 0.2;
+  options.beta = 0.01;
+  options.threads = 1;
+  CVB0LDA lda;
+  ASSERT_TRUE(lda.Init(options, dataset));
+
+  std::vector<double> ppxs(1, lda.Perplexity());
+  for (int iter = 0; iter < 20; ++iter) {
+    lda.Sweep();
+    ppxs.push_back(lda.Perplexity());
+  }
+  for (std::size_t i = 1; i < ppxs.size(); ++i) {
+    EXPECT_LE(ppxs[i], ppxs[i - 1] * (1 + 1e-9)) << "sweep " << i;
+  }
+  EXPECT_LT(ppxs.back(), 0.9 * ppxs.front());
+  // two separated topics of 4 words each leave about 4 choices per word
+  EXPECT_LT(ppxs.back(), 4.5);
+}
+
+} /* namespace toyml */
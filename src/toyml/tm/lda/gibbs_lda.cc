@@ -11,10 +11,15 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <cmath>
 #include <glog/logging.h>
 
 namespace toyml {
 
+GibbsLDA::GibbsLDA() :
+    evaluator_(NULL), eval_interval_(0) {
+}
+
 GibbsLDA::~GibbsLDA() {
 }
 
@@ -27,22 +32,83 @@ bool GibbsLDA::Init(const LDAOptions& options, const DocumentSet& dataset) {
 
 std::size_t GibbsLDA::Train() {
   SaveModel(0);
-  VLOG(0) << "[begin]";
+  double pre_lik = LogLikelihood();
+  VLOG(0) << "[begin] L=" << std::setprecision(10) << pre_lik;
   for (iter_ = 1; iter_ <= options_.iters; ++iter_) {
-    VLOG_EVERY_N(0, options_.nlog) << "Iteration#" << iter_;
     if (iter_ % options_.nsave == 0) {
       SaveModel(iter_);
     }
-    for (std::size_t d = 0; d < nd_; ++d) {
-      const Document& doc = dataset_->Doc(d);
-      for (std::size_t wi = 0; wi < doc.Size(); ++wi) {
-        Sampling(d, wi);
+    Sweep();
+    if (evaluator_ && eval_interval_ > 0 && iter_ % eval_interval_ == 0) {
+      TopicWordProb(&eval_p_w_z_);
+      evaluator_->EvaluateAsync(eval_p_w_z_, iter_);
+    }
+    if (iter_ % options_.nlog == 0) {
+      double cur_lik = LogLikelihood();
+      VLOG(0) << "Iteration#" << iter_ << " L=" << std::setprecision(10) << cur_lik;
+      if (options_.eps > 0 && cur_lik - pre_lik < options_.eps * std::fabs(pre_lik)) {
+        VLOG(0) << "[break] Iteration#" << iter_ << " L=" << cur_lik << ", eps=" << options_.eps;
+        break;
       }
+      pre_lik = cur_lik;
     }
   }
   VLOG(0) << "[end]";
+  if (evaluator_) {
+    evaluator_->Wait();
+    TopicWordProb(&eval_p_w_z_);
+    VLOG(0) << "[end] held-out perplexity=" << std::setprecision(10) << evaluator_->Perplexity(eval_p_w_z_);
+  }
   SaveModel(options_.finalsuffix);
-  return std::min(iter_ + 1, options_.iters);
+  return std::min(iter_, options_.iters);
+}
+
+void GibbsLDA::Sweep() {
+  for (std::size_t d = 0; d < nd_; ++d) {
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t wi = 0, w, n; reader.Next(&w, &n); ++wi) {
+      Sampling(d, wi, w);
+    }
+  }
+  loglik_ += log(ratio_);
+  ratio_ = 1;
+}
+
+double GibbsLDA::ExactLogLikelihood() const {
+  double lik = nz_ * lgamma(vbeta_) + nd_ * lgamma(kalpha_);
+  double lgamma_beta = lgamma(beta_);
+  double lgamma_alpha = lgamma(alpha_);
+  for (Size z = 0; z < nz_; ++z) {
+    lik -= lgamma(c_z_(z) + vbeta_);
+    for (Size w = 0; w < nw_; ++w) {
+      lik += lgamma(c_zw_(z, w) + beta_) - lgamma_beta;
+    }
+  }
+  for (Size d = 0; d < nd_; ++d) {
+    lik -= lgamma(c_d_(d) + kalpha_);
+    for (Size z = 0; z < nz_; ++z) {
+      lik += lgamma(c_dz_(d, z) + alpha_) - lgamma_alpha;
+    }
+  }
+  return lik;
+}
+
+double GibbsLDA::Perplexity() const {
+  double lik = 0;
+  std::size_t nwords = 0;
+  for (Size d = 0; d < nd_; ++d) {
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      double p_dw = 0;
+      for (Size z = 0; z < nz_; ++z) {
+        p_dw += (c_zw_(z, w) + beta_) / (c_z_(z) + vbeta_) *
+            (c_dz_(d, z) + alpha_) / (c_d_(d) + kalpha_);
+      }
+      lik += n * log(p_dw);
+      nwords += n;
+    }
+  }
+  return nwords > 0 ? exp(-lik / nwords) : 0;
 }
 
 void GibbsLDA::Initialize() {
@@ -68,10 +134,9 @@ void GibbsLDA::Initialize() {
 
   z_.resize(nd_);
   for (std::size_t d = 0; d < nd_; ++d) {
-    const Document& doc = dataset_->Doc(d);
-    z_[d].resize(doc.Size());
-    for (std::size_t wi = 0; wi < doc.Size(); ++wi) {
-      Size w = doc.Word(wi);
+    EntryReader reader = dataset_->DocReader(d);
+    z_[d].resize(reader.Size());
+    for (uint32_t wi = 0, w, n; reader.Next(&w, &n); ++wi) {
       Size z = static_cast<Size>((static_cast<double>(std::rand()) / RAND_MAX) * nz_);
       z_[d][wi] = z;
       ++c_dz_(d, z);
@@ -82,14 +147,16 @@ void GibbsLDA::Initialize() {
   }
 
   p_z_.resize(nz_);
+  loglik_ = ExactLogLikelihood();
+  ratio_ = 1;
 
   theta_.resize(nd_, nz_);
   phi_.resize(nz_, nw_);
 }
 
-Size GibbsLDA::Sampling(Size d, Size wi) {
-  Size w = dataset_->Doc(d).Word(wi);
-  Size z = z_[d][wi];
+Size GibbsLDA::Sampling(Size d, Size wi, Size w) {
+  Size old_z = z_[d][wi];
+  Size z = old_z;
   --c_dz_(d, z);
   --c_d_(d);
   --c_zw_(z, w);
@@ -109,6 +176,15 @@ Size GibbsLDA::Sampling(Size d, Size wi) {
     }
   }
   VLOG(4) << "new_z=" << z;
+  if (z != old_z) {
+    // p(w, z) changes by the ratio of the two terms of p_z_ without the common c_d_(d)
+    ratio_ *= (c_zw_(z, w) + beta_) * (c_z_(old_z) + vbeta_) * (c_dz_(d, z) + alpha_) /
+        ((c_zw_(old_z, w) + beta_) * (c_z_(z) + vbeta_) * (c_dz_(d, old_z) + alpha_));
+    if (ratio_ > 1e100 || ratio_ < 1e-100) {
+      loglik_ += log(ratio_);
+      ratio_ = 1;
+    }
+  }
   z_[d][wi] = z;
   ++c_dz_(d, z);
   ++c_d_(d);
@@ -118,6 +194,15 @@ Size GibbsLDA::Sampling(Size d, Size wi) {
   return 0;
 }
 
+void GibbsLDA::TopicWordProb(ublas::matrix<double>* p_w_z) const {
+  p_w_z->resize(nw_, nz_, false);
+  for (std::size_t w = 0; w < nw_; ++w) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      (*p_w_z)(w, z) = (c_zw_(z, w) + beta_) / (c_z_(z) + vbeta_);
+    }
+  }
+}
+
 std::string GibbsLDA::ToString() const {
   std::stringstream ss;
   ss << NVC_(nd_) << NVC_(nz_) << NVC_(nw_) << NVC_(alpha_) << NV_(beta_);
@@ -153,25 +238,18 @@ bool GibbsLDA::SaveModel(const std::string& suffix) {
 }
 
 bool GibbsLDA::SaveTopics(const std::string& path) const {
-  typedef std::pair<double, Size> ProbWord;
-
   std::ofstream outf(path.c_str());
   if (!outf) {
     LOG(ERROR) << "Failed to save topics to " << path;
     return false;
   }
 
-  std::vector<ProbWord> vec;
-  vec.reserve(nw_);
+  std::vector<std::vector<Utils::ProbId> > tops;
+  Utils::TopK(phi_, false, options_.topn, &tops);
   for (std::size_t z = 0; z < nz_; ++z) {
-    vec.clear();
-    for (std::size_t w = 0; w < nw_; ++w) {
-      vec.push_back(ProbWord(phi_(z, w), w));
-    }
-    std::sort(vec.begin(), vec.end(), std::greater<ProbWord>());
-
+    const std::vector<Utils::ProbId>& vec = tops[z];
     outf << "Topic #" << z << ":\n";
-    for (std::size_t i = 0; i < vec.size() && i < options_.topn; ++i) {
+    for (std::size_t i = 0; i < vec.size(); ++i) {
       outf << "\t" << dataset_->Word(vec[i].second) << "\t" << vec[i].first << "\n";
     }
   }
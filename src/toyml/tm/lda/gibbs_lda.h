@@ -11,6 +11,7 @@
 #include <boost/numeric/ublas/matrix.hpp>
 
 #include "lda.h"
+#include <toyml/tm/heldout.h>
 
 namespace toyml {
 
@@ -23,11 +24,28 @@ typedef std::size_t Size;
  */
 class GibbsLDA {
 public:
+  GibbsLDA();
   virtual ~GibbsLDA();
 
   bool Init(const LDAOptions& options, const DocumentSet& dataset);
+  // Evaluates p(w|z) on evaluator in the background every interval sweeps of Train
+  void set_evaluator(HeldoutEvaluator* evaluator, std::size_t interval) {
+    evaluator_ = evaluator;
+    eval_interval_ = interval;
+  }
   std::size_t Train();
+  void Sweep();
+  double Perplexity() const;
+  // log p(w, z) of the current topic assignments, kept up to date by the
+  // sweeps in O(1) per moved word
+  double LogLikelihood() const {
+    return loglik_;
+  }
+  // log p(w, z) recomputed from the counts in O(nz * (nw + nd))
+  double ExactLogLikelihood() const;
   std::string ToString() const;
+  // p_w_z(w, z) = p(w|z), the nw x nz layout of HeldoutEvaluator
+  void TopicWordProb(ublas::matrix<double>* p_w_z) const;
 
   bool SaveModel(int no);
   bool SaveModel(const std::string& suffix = "");
@@ -52,14 +70,20 @@ private:
 
   std::vector<std::vector<Size> > z_;     // z_(d, w): the topic assigned to word w in document d
   ublas::vector<double> p_z_;
+  double loglik_;   // log p(w, z) up to the last Sweep
+  double ratio_;    // product of the changes of p(w, z) not yet added to loglik_
 
   ublas::matrix<double> theta_;   // document-topic distributions
   ublas::matrix<double> phi_;     // topic-word distributions
 
   std::size_t iter_;    // current iteration
 
+  HeldoutEvaluator* evaluator_;
+  std::size_t eval_interval_;
+  ublas::matrix<double> eval_p_w_z_;
+
   void Initialize();
-  Size Sampling(Size d, Size w);
+  Size Sampling(Size d, Size wi, Size w);
   void CalcThetaPhi();
   std::string Path(const std::string& fname, const std::string& suffix) const;
 };
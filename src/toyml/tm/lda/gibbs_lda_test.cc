@@ -6,7 +6,33 @@
  */
 
 #include "gibbs_lda.h"
+#include <cmath>
+#include <gtest/gtest.h>
 
 namespace toyml {
 
+TEST(GibbsLDA, RunningLogLikelihoodIsExact) {
+  std::stringstream ss;
+  for (int i = 0; i < 20; ++i) {
+    ss << "apple banana cherry apple banana date\n";
+    ss << "dog eel fox dog eel goat apple\n";
+  }
+  DocumentSet dataset;
+  ASSERT_EQ(40U, dataset.LoadNext(ss, 100));
+
+  LDAOptions options;
+  options.topics = 3;
+  options.alpha = 0.2;
+  options.beta = 0.01;
+  GibbsLDA lda;
+  ASSERT_TRUE(lda.Init(options, dataset));
+  EXPECT_NEAR(lda.ExactLogLikelihood(), lda.LogLikelihood(),
+      1e-9 * std::fabs(lda.ExactLogLikelihood()));
+  for (int iter = 0; iter < 5; ++iter) {
+    lda.Sweep();
+    EXPECT_NEAR(lda.ExactLogLikelihood(), lda.LogLikelihood(),
+        1e-9 * std::fabs(lda.ExactLogLikelihood())) << "sweep " << iter;
+  }
+}
+
 } /* namespace toyml */
@@ -7,12 +7,368 @@
 
 #include "lda.h"
 
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <glog/logging.h>
+#include <toyml/util/util.h>
+
 namespace toyml {
 
-LDA::LDA() {
+static const double kMeanChangeThresh = 1e-3;
+static const double kMinScale = 1e-100;
+
+LDA::LDA(): nw_(0), nz_(0), alpha_(0), eta_(0), scale_(1), updates_(0), ndocs_(0) {
 }
 
 LDA::~LDA() {
 }
 
+bool LDA::Init(const LDAOptions& options) {
+  if (options.kappa <= 0.5 || options.kappa > 1 || options.tau0 < 0) {
+    LOG(ERROR) << "kappa=" << options.kappa << " which should be (0.5, 1], tau0=" << options.tau0;
+    return false;
+  }
+  if (options.batch_size == 0 || options.topics == 0) {
+    LOG(ERROR) << "batch_size=" << options.batch_size << ", topics=" << options.topics;
+    return false;
+  }
+  options_ = options;
+  if (options_.random) {
+    std::srand(std::time(NULL));
+  } else {
+    std::srand(0);
+  }
+
+  nz_ = options_.topics;
+  nw_ = 0;
+  alpha_ = options_.alpha / nz_;
+  eta_ = options_.beta;
+  m_.clear();
+  msum_.assign(nz_, 0);
+  scale_ = 1;
+  updates_ = 0;
+  ndocs_ = 0;
+  local_.clear();
+  batch_.Clear();
+  return true;
+}
+
+bool LDA::LoadModel(const std::string& suffix) {
+  if (!batch_.LoadDict(Path(options_.vocabpath, suffix))) {
+    return false;
+  }
+  std::string path = Path(options_.lambdapath, suffix);
+  std::ifstream inf(path.c_str());
+  if (!inf) {
+    LOG(ERROR) << "Failed to open model file " << path;
+    return false;
+  }
+  std::size_t nw = 0;
+  std::size_t nz = 0;
+  inf >> nw >> nz >> updates_ >> ndocs_;
+  if (nz != nz_ || nw != batch_.DictSize()) {
+    LOG(ERROR) << "Mismatched model " << path << ": " << NVC_(nw) << NVC_(nz)
+        << NVC_(nz_) << "DictSize=" << batch_.DictSize();
+    return false;
+  }
+  nw_ = nw;
+  scale_ = 1;
+  m_.resize(nw_ * nz_);
+  msum_.assign(nz_, 0);
+  for (std::size_t w = 0; w < nw_; ++w) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      double lambda = 0;
+      if (!(inf >> lambda)) {
+        LOG(ERROR) << "Truncated model file " << path;
+        return false;
+      }
+      m_[w * nz_ + z] = lambda - eta_;
+      msum_[z] += lambda - eta_;
+    }
+  }
+  local_.assign(nw_, -1);
+  VLOG(0) << "Loaded model from " << path << ": " << ToString();
+  return true;
+}
+
+std::size_t LDA::Train(const std::string& path) {
+  VLOG(0) << "[begin]";
+  std::size_t pass = 0;
+  for (; pass < options_.iters; ++pass) {
+    std::ifstream inf(path.c_str());
+    if (!inf) {
+      LOG(ERROR) << "Failed to open data file " << path;
+      break;
+    }
+    VLOG(0) << "Pass#" << pass + 1;
+    // only the first pass streams new documents
+    Pass(inf, pass == 0);
+  }
+  VLOG(0) << "[end]";
+  SaveModel(options_.finalsuffix);
+  return pass;
+}
+
+std::size_t LDA::Train(std::istream& is) {
+  return Pass(is, true);
+}
+
+std::size_t LDA::Pass(std::istream& is, bool count) {
+  std::size_t nbatches = 0;
+  while (batch_.LoadNext(is, options_.batch_size) > 0) {
+    if (count) {
+      ndocs_ += batch_.DocSize();
+    }
+    double ppx = Update();
+    ++nbatches;
+    VLOG_IF(0, updates_ % options_.nlog == 0) << "Batch#" << updates_ << " perplexity="
+        << std::setprecision(10) << ppx << ", " << ToString();
+    if (updates_ % options_.nsave == 0) {
+      SaveModel(updates_);
+    }
+  }
+  return nbatches;
+}
+
+void LDA::Grow() {
+  std::size_t nw = batch_.DictSize();
+  if (nw <= nw_) return;
+  m_.resize(nw * nz_);
+  for (std::size_t w = nw_; w < nw; ++w) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      double r = (0.9 + 0.2 * std::rand() / RAND_MAX) / scale_;
+      m_[w * nz_ + z] = r;
+      msum_[z] += r;
+    }
+  }
+  local_.resize(nw, -1);
+  nw_ = nw;
+}
+
+double LDA::Update() {
+  Grow();
+
+  words_.clear();
+  for (std::size_t d = 0; d < batch_.DocSize(); ++d) {
+    const Document& doc = batch_.Doc(d);
+    for (uint32_t p = 0; p < doc.Size(); ++p) {
+      uint32_t w = doc.Word(p);
+      if (local_[w] < 0) {
+        local_[w] = words_.size();
+        words_.push_back(w);
+      }
+    }
+  }
+
+  std::size_t nlocal = words_.size();
+  exp_elogbeta_.resize(nlocal * nz_);
+  sstats_.assign(nlocal * nz_, 0);
+  std::vector<double> dgsum(nz_);
+  for (std::size_t z = 0; z < nz_; ++z) {
+    dgsum[z] = Utils::Digamma(LambdaSum(z));
+  }
+  for (std::size_t i = 0; i < nlocal; ++i) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      exp_elogbeta_[i * nz_ + z] = Utils::Digamma(Lambda(words_[i], z)) - dgsum[z];
+    }
+  }
+  if (nlocal > 0) Util::Exp(&exp_elogbeta_[0], nlocal * nz_);
+
+  // E-step
+  double lik = 0;
+  std::size_t nwords = batch_.TotalWordOccurs();
+  std::vector<double> gamma(nz_);
+  for (std::size_t d = 0; d < batch_.DocSize(); ++d) {
+    lik += EStep(batch_.Doc(d), &gamma);
+  }
+
+  // M-step: lambda = (1 - rho) * lambda + rho * (eta + D / |B| * sstats),
+  // where rho = (tau0 + t)^(-kappa) of the t-th mini-batch is in (0, 1] for tau0 >= 0
+  double rho = pow(options_.tau0 + updates_ + 1, -options_.kappa);
+  double ndocs = options_.ndocs > 0 ? options_.ndocs : std::max(ndocs_, batch_.DocSize());
+  double factor = rho * ndocs / batch_.DocSize();
+  double decay = 1 - rho;
+  if (scale_ * decay < kMinScale) {
+    for (std::size_t i = 0; i < m_.size(); ++i) {
+      m_[i] *= scale_ * decay;
+    }
+    for (std::size_t z = 0; z < nz_; ++z) {
+      msum_[z] *= scale_ * decay;
+    }
+    scale_ = 1;
+  } else {
+    scale_ *= decay;
+  }
+  for (std::size_t i = 0; i < nlocal; ++i) {
+    double* m = &m_[words_[i] * nz_];
+    for (std::size_t z = 0; z < nz_; ++z) {
+      double delta = factor * sstats_[i * nz_ + z] * exp_elogbeta_[i * nz_ + z] / scale_;
+      m[z] += delta;
+      msum_[z] += delta;
+    }
+    local_[words_[i]] = -1;
+  }
+  ++updates_;
+
+  return nwords > 0 ? exp(-lik / nwords) : 0;
+}
+
+double LDA::EStep(const Document& doc, std::vector<double>* gamma) {
+  std::vector<double>& g = *gamma;
+  std::vector<double> exp_elogtheta(nz_);
+  std::vector<double> phinorm(doc.Size());
+  std::vector<double> s(nz_);
+  double total = 0;
+  for (uint32_t p = 0; p < doc.Size(); ++p) {
+    total += doc.Freq(p);
+  }
+  g.assign(nz_, alpha_ + total / nz_);
+
+  bool converged = false;
+  for (std::size_t iter = 0; ; ++iter) {
+    double sum = 0;
+    for (std::size_t z = 0; z < nz_; ++z) {
+      sum += g[z];
+    }
+    double dgsum = Utils::Digamma(sum);
+    for (std::size_t z = 0; z < nz_; ++z) {
+      exp_elogtheta[z] = Utils::Digamma(g[z]) - dgsum;
+    }
+    Util::Exp(&exp_elogtheta[0], nz_);
+    for (uint32_t p = 0; p < doc.Size(); ++p) {
+      const double* eb = &exp_elogbeta_[local_[doc.Word(p)] * nz_];
+      double norm = 1e-100;
+      for (std::size_t z = 0; z < nz_; ++z) {
+        norm += exp_elogtheta[z] * eb[z];
+      }
+      phinorm[p] = norm;
+    }
+    if (converged || iter == options_.estep_iters) break;
+
+    std::fill(s.begin(), s.end(), 0);
+    for (uint32_t p = 0; p < doc.Size(); ++p) {
+      const double* eb = &exp_elogbeta_[local_[doc.Word(p)] * nz_];
+      double np = doc.Freq(p) / phinorm[p];
+      for (std::size_t z = 0; z < nz_; ++z) {
+        s[z] += np * eb[z];
+      }
+    }
+    double change = 0;
+    for (std::size_t z = 0; z < nz_; ++z) {
+      double gz = alpha_ + exp_elogtheta[z] * s[z];
+      change += fabs(gz - g[z]);
+      g[z] = gz;
+    }
+    converged = change / nz_ < kMeanChangeThresh;
+  }
+
+  double sum = 0;
+  for (std::size_t z = 0; z < nz_; ++z) {
+    sum += g[z];
+  }
+  double lik = 0;
+  for (uint32_t p = 0; p < doc.Size(); ++p) {
+    uint32_t w = doc.Word(p);
+    double* ss = &sstats_[local_[w] * nz_];
+    double np = doc.Freq(p) / phinorm[p];
+    double p_dw = 0;
+    for (std::size_t z = 0; z < nz_; ++z) {
+      ss[z] += exp_elogtheta[z] * np;
+      p_dw += g[z] / sum * Lambda(w, z) / LambdaSum(z);
+    }
+    lik += doc.Freq(p) * log(p_dw);
+  }
+  return lik;
+}
+
+std::string LDA::ToString() const {
+  std::stringstream ss;
+  ss << NVC_(nw_) << NVC_(nz_) << NVC_(alpha_) << NVC_(eta_) << NVC_(updates_) << NV_(ndocs_);
+  return ss.str();
+}
+
+bool LDA::SaveModel(int no) const {
+  std::stringstream ss;
+  ss << no;
+  return SaveModel(ss.str());
+}
+
+bool LDA::SaveModel(const std::string& suffix) const {
+  VLOG(0) << "SaveModel suffix=" << suffix;
+  bool ret = SaveTopics(Path(options_.zpath, suffix));
+  ret &= batch_.SaveDict(Path(options_.vocabpath, suffix));
+
+  std::string path = Path(options_.lambdapath, suffix);
+  std::ofstream outf(path.c_str());
+  if (!outf) {
+    LOG(ERROR) << "Failed to save model to " << path;
+    return false;
+  }
+  outf << std::setprecision(10);
+  outf << nw_ << '\t' << nz_ << '\t' << updates_ << '\t' << ndocs_ << '\n';
+  for (std::size_t w = 0; w < nw_; ++w) {
+    for (std::size_t z = 0; z < nz_; ++z) {
+      outf << Lambda(w, z) << '\t';
+    }
+    outf << '\n';
+  }
+  outf.close();
+
+  path = Path(options_.zwpath, suffix);
+  outf.open(path.c_str());
+  if (!outf) {
+    LOG(ERROR) << "Failed to save matrix to " << path;
+    return false;
+  }
+  outf << nz_ << '\t' << nw_ << '\n';
+  for (std::size_t z = 0; z < nz_; ++z) {
+    double sum = LambdaSum(z);
+    for (std::size_t w = 0; w < nw_; ++w) {
+      outf << Lambda(w, z) / sum << '\t';
+    }
+    outf << '\n';
+  }
+  outf.close();
+  return ret;
+}
+
+bool LDA::SaveTopics(const std::string& path) const {
+  std::ofstream outf(path.c_str());
+  if (!outf) {
+    LOG(ERROR) << "Failed to save topics to " << path;
+    return false;
+  }
+
+  // lambda(w, z) grows with m_[w * nz_ + z] since scale_ > 0, so the top words
+  // of topic z are selected from column z of m_ in place
+  std::vector<Utils::ProbId> top;
+  for (std::size_t z = 0; z < nz_; ++z) {
+    double sum = LambdaSum(z);
+    Utils::TopK(m_.empty() ? NULL : &m_[z], nw_, nz_, options_.topn, &top);
+
+    outf << "Topic #" << z << ":\n";
+    for (std::size_t i = 0; i < top.size(); ++i) {
+      uint32_t w = top[i].second;
+      outf << "\t" << batch_.Word(w) << "\t" << Lambda(w, z) / sum << "\n";
+    }
+  }
+
+  outf.close();
+  VLOG(2) << "Saved topics to " << path;
+  return true;
+}
+
+std::string LDA::Path(const std::string& fname, const std::string& suffix) const {
+  if (suffix.length() == 0) {
+    return options_.datadir + "/" + fname;
+  } else {
+    return options_.datadir + "/" + fname + "." + suffix;
+  }
+}
+
 } /* namespace toyml */
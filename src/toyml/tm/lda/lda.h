@@ -9,6 +9,7 @@
 #define LDA_H_
 
 #include <string>
+#include <vector>
 
 #include <toyml/tm/utils.h>
 #include <toyml/tm/dataset.h>
@@ -20,21 +21,31 @@ struct LDAOptions {
   double beta;
   std::size_t topics;  // number of topics
   std::size_t iters;
-  double eps;
+  double eps;  // relative improvement over nlog sweeps below which GibbsLDA and CVB0LDA stop, 0 disables it for GibbsLDA
   int nlog;
   int nsave;
   std::size_t topn;
+  std::size_t threads;  // 0 means using all the cores
+  std::size_t batch_size;   // documents per mini-batch of online LDA
+  double tau0;              // delay of the learning rate of online LDA
+  double kappa;             // forgetting rate of online LDA, in (0.5, 1]
+  std::size_t estep_iters;  // maximum iterations of the per-document E-step of online LDA
+  std::size_t ndocs;        // corpus size D of online LDA, 0 means the number of documents streamed
   std::string datadir;
   std::string finalsuffix;
   std::string seperator;
   std::string zpath;
   std::string zwpath;
   std::string dzpath;
+  std::string lambdapath;
+  std::string vocabpath;
   bool random;
   LDAOptions() :
       alpha(50.0), beta(0.1), topics(30), iters(100), eps(1e-3), nlog(
-          10), nsave(10), topn(10), datadir("./"), finalsuffix("final"), seperator(
-          "\t"), zpath("topics.dat"), zwpath("topic-word-prob.dat"), dzpath("doc-topic-prob.dat"), random(false) {
+          10), nsave(10), topn(10), threads(0),
+      batch_size(256), tau0(1024), kappa(0.7), estep_iters(100), ndocs(0), datadir("./"), finalsuffix("final"), seperator(
+          "\t"), zpath("topics.dat"), zwpath("topic-word-prob.dat"), dzpath("doc-topic-prob.dat"),
+      lambdapath("topic-word-lambda.dat"), vocabpath("vocab.dat"), random(false) {
   }
   std::string ToString() const {
     std::stringstream ss;
@@ -45,6 +56,8 @@ struct LDAOptions {
     ss << NVC_(nlog);
     ss << NVC_(nsave);
     ss << NVC_(topn);
+    ss << NVC_(threads);
+    ss << NVC_(batch_size) << NVC_(tau0) << NVC_(kappa) << NVC_(estep_iters) << NVC_(ndocs);
     ss << NVC_(random);
     ss << NV_(datadir);
     return ss.str();
@@ -52,15 +65,67 @@ struct LDAOptions {
 };
 
 /**
- * @brief 
+ * @brief LDA using online variational Bayes (Hoffman et al., 2010)
+ *
+ * Documents are streamed from disk in mini-batches of options.batch_size and
+ * are never held in memory all at once. The vocabulary grows as new words are
+ * streamed, and the topic-word parameters lambda are updated after every
+ * mini-batch t = 1, 2, ... with the learning rate (tau0 + t)^(-kappa). A
+ * saved model can be loaded by LoadModel to continue training on new
+ * documents.
  */
 class LDA {
 public:
   LDA();
   virtual ~LDA();
 
-  bool Init(const LDAOptions& options, const DocumentSet& dataset);
-  bool Train();
+  bool Init(const LDAOptions& options);
+  bool LoadModel(const std::string& suffix);
+  // Streams the documents of path options.iters times, returns the number of passes
+  std::size_t Train(const std::string& path);
+  // Trains on the rest of the stream, returns the number of mini-batches
+  std::size_t Train(std::istream& is);
+  std::string ToString() const;
+
+  const DocumentSet& dataset() const { return batch_; }
+  bool SaveModel(int no) const;
+  bool SaveModel(const std::string& suffix = "") const;
+  bool SaveTopics(const std::string& path) const;
+protected:
+  LDAOptions options_;
+  DocumentSet batch_;     // current mini-batch, which also owns the vocabulary
+
+  std::size_t nw_;  // size of vocabulary
+  std::size_t nz_;  // number of topics
+
+  double alpha_;
+  double eta_;
+
+  // lambda(w, z) = eta_ + scale_ * m_[w * nz_ + z], so the decay of all the
+  // words can be applied to scale_ in O(1) instead of O(nw_ * nz_) per batch.
+  std::vector<double> m_;
+  std::vector<double> msum_;    // msum_[z]: sum of m_ over words
+  double scale_;
+
+  std::size_t updates_;   // number of mini-batches trained
+  std::size_t ndocs_;     // number of documents streamed in the first pass
+
+  std::vector<int> local_;            // local_[w]: row of w in the mini-batch buffers, or -1
+  std::vector<uint32_t> words_;       // words of the mini-batch
+  std::vector<double> exp_elogbeta_;  // exp(E[log(beta(z, w))]) of the mini-batch words
+  std::vector<double> sstats_;        // sufficient statistics of the mini-batch words
+
+  double Lambda(std::size_t w, std::size_t z) const {
+    return eta_ + scale_ * m_[w * nz_ + z];
+  }
+  double LambdaSum(std::size_t z) const {
+    return nw_ * eta_ + scale_ * msum_[z];
+  }
+  std::size_t Pass(std::istream& is, bool count);
+  void Grow();
+  double Update();
+  double EStep(const Document& doc, std::vector<double>* gamma);
+  std::string Path(const std::string& fname, const std::string& suffix) const;
 };
 
 } /* namespace toyml */
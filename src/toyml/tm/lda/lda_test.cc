@@ -6,7 +6,109 @@
  */
 
 #include "lda.h"
+#include <cmath>
+#include <cstdio>
+#include <gtest/gtest.h>
 
 namespace toyml {
 
+/**
+ * @brief Streams mini-batches through online LDA without saving the model
+ */
+class OnlineLDARunner : public LDA {
+public:
+  // Returns the mean perplexity of the mini-batches of is, each measured
+  // before its update
+  double Pass(std::istream& is) {
+    double sum = 0;
+    std::size_t nbatches = 0;
+    while (batch_.LoadNext(is, options_.batch_size) > 0) {
+      sum += Update();
+      ++nbatches;
+    }
+    return nbatches > 0 ? sum / nbatches : 0;
+  }
+  std::size_t nw() const {
+    return nw_;
+  }
+  std::size_t updates() const {
+    return updates_;
+  }
+  double lambda(std::size_t w, std::size_t z) const {
+    return Lambda(w, z);
+  }
+};
+
+class OnlineLDATest: public testing::Test {
+protected:
+  virtual void SetUp() {
+    for (int i = 0; i < 20; ++i) {
+      corpus_ += "apple banana cherry apple banana date\n";
+      corpus_ += "dog eel fox dog eel goat\n";
+    }
+    options_.topics = 2;
+    options_.alpha = 0.2;
+    options_.beta = 0.01;
+    options_.batch_size = 8;
+    options_.tau0 = 1;
+    options_.ndocs = 40;
+    options_.datadir = ".";
+  }
+
+  std::string corpus_;
+  LDAOptions options_;
+};
+
+TEST_F(OnlineLDATest, PerplexityDecreases) {
+  OnlineLDARunner lda;
+  ASSERT_TRUE(lda.Init(options_));
+  std::vector<double> ppxs;
+  for (int pass = 0; pass < 10; ++pass) {
+    std::stringstream ss(corpus_);
+    ppxs.push_back(lda.Pass(ss));
+  }
+  EXPECT_EQ(50u, lda.updates());
+  for (std::size_t i = 1; i < ppxs.size(); ++i) {
+    EXPECT_LE(ppxs[i], ppxs[i - 1] * (1 + 1e-9)) << "pass " << i;
+  }
+  EXPECT_LT(ppxs.back(), 0.9 * ppxs.front());
+  // two separated topics of 4 words each leave about 4 choices per word
+  EXPECT_LT(ppxs.back(), 4.5);
+}
+
+TEST_F(OnlineLDATest, SaveAndLoadModel) {
+  OnlineLDARunner lda;
+  ASSERT_TRUE(lda.Init(options_));
+  std::stringstream ss(corpus_);
+  lda.Pass(ss);
+  ASSERT_TRUE(lda.SaveModel("test"));
+
+  OnlineLDARunner loaded;
+  ASSERT_TRUE(loaded.Init(options_));
+  ASSERT_TRUE(loaded.LoadModel("test"));
+  EXPECT_EQ(lda.updates(), loaded.updates());
+  ASSERT_EQ(lda.nw(), loaded.nw());
+  for (std::size_t w = 0; w < lda.nw(); ++w) {
+    EXPECT_EQ(lda.dataset().Word(w), loaded.dataset().Word(w));
+    for (std::size_t z = 0; z < options_.topics; ++z) {
+      // lambda is saved with 10 significant digits
+      EXPECT_NEAR(lda.lambda(w, z), loaded.lambda(w, z), 1e-9 * lda.lambda(w, z))
+          << "w=" << w << ", z=" << z;
+    }
+  }
+
+  // a model of another number of topics does not load
+  LDAOptions options = options_;
+  options.topics = 3;
+  OnlineLDARunner mismatched;
+  ASSERT_TRUE(mismatched.Init(options));
+  EXPECT_FALSE(mismatched.LoadModel("test"));
+
+  const char* files[] = {"topics.dat.test", "vocab.dat.test", "topic-word-lambda.dat.test",
+      "topic-word-prob.dat.test"};
+  for (std::size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+    EXPECT_EQ(0, std::remove((std::string("./") + files[i]).c_str())) << files[i];
+  }
+}
+
 } /* namespace toyml */
@@ -20,6 +20,10 @@ bool BackgroundPLSA::Init(const BackgroundPLSAOptions& options, const DocumentSe
     LOG(ERROR) << "lambda=" << options.lambda << " which should be [0, 1]";
     return false;
   }
+  if (options.prune_after > 0) {
+    LOG(ERROR) << "Pruning p(w|z) is not supported with a background model";
+    return false;
+  }
   boptions_ = options;
   lambda_ = options.lambda;
 
@@ -35,10 +39,8 @@ double BackgroundPLSA::LogLikelihood() {
   VLOG(2) << "LogLikelihood";
   double lik = 0;
   for (uint32_t d = 0; d < nd_; ++d) {
-    const Document& doc = dataset_->Doc(d);
-    for (uint32_t p = 0; p < doc.Size(); ++p) {
-      uint32_t w = doc.Word(p);
-      uint32_t n = doc.Freq(p);
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
       double p_dw = 0;
       for (uint32_t z = 0; z < nz_; ++z) {
         p_dw += p_z_d_(z, d) * p_w_z_(w, z);
@@ -57,48 +59,20 @@ void BackgroundPLSA::InitProb() {
   dataset_->CalcWordProb(p_w_b_);
 }
 
-void BackgroundPLSA::EMStep() {
-  VLOG(2) << "EMStep";
-
-  p_d_new_.clear();
-  p_z_new_.clear();
-  p_z_d_new_.clear();
-  p_w_z_new_.clear();
-
-  for (uint32_t d = 0; d < nd_; ++d) {
-    const Document& doc = dataset_->Doc(d);
-    for (uint32_t p = 0; p < doc.Size(); ++p) {
-      uint32_t w = doc.Word(p);
-      uint32_t n = doc.Freq(p);
-
-      // Estep
-      double norm = 0;
-      for (uint32_t z = 0; z < nz_; ++z) {
-        double p_zdw = p_z_d_(z, d) * p_w_z_(w, z);
-        p_z_dw_(z) = p_zdw;
-        norm += p_zdw;
-      }
-//      CHECK(norm > 0) << "Iter#" << iter_ << " norm=" << norm << ", d=" << d << ", w=" << w << ", SaveModel=" << SaveModel("debug");
-      for (uint32_t z = 0; z < nz_; ++z) {
-        p_z_dw_(z) /= norm;
-      }
-      double p_w_b = lambda_ * p_w_b_(w);
-      double p_b_dw = p_w_b / (p_w_b + (1 - lambda_) * norm);
-//      VLOG_EVERY_N(0, 1000) << "#" << google::COUNTER << " p_w_b=" << p_w_b << ", norm=" << norm << ", p_dwb=" << p_b_dw;
-
-      // Mstep
-      for (uint32_t z = 0; z < nz_; ++z) {
-//        double np = n * p_z_dw_(z);
-        double np = n * (1 - p_b_dw) * p_z_dw_(z) + delta_;
-        p_w_z_new_(w, z) += np;
-        p_z_d_new_(z, d) += np;
-        p_z_new_(z) += np;
-        p_d_new_(d) += np;
-      }
-    }
+void BackgroundPLSA::EStep(uint32_t d, uint32_t w, uint32_t n) {
+  double norm = 0;
+  for (uint32_t z = 0; z < nz_; ++z) {
+    double p_zdw = p_z_d_(z, d) * p_w_z_(w, z);
+    p_z_dw_(z) = p_zdw;
+    norm += p_zdw;
+  }
+//  CHECK(norm > 0) << "Iter#" << iter_ << " norm=" << norm << ", d=" << d << ", w=" << w << ", SaveModel=" << SaveModel("debug");
+  double p_w_b = lambda_ * p_w_b_(w);
+  double p_b_dw = p_w_b / (p_w_b + (1 - lambda_) * norm);
+//  VLOG_EVERY_N(0, 1000) << "#" << google::COUNTER << " p_w_b=" << p_w_b << ", norm=" << norm << ", p_dwb=" << p_b_dw;
+  for (uint32_t z = 0; z < nz_; ++z) {
+    p_z_dw_(z) = n * (1 - p_b_dw) * (p_z_dw_(z) / norm) + delta_;
   }
-
-  Normalize();
 }
 
 } /* namespace toyml */
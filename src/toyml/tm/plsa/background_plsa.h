@@ -48,7 +48,7 @@ protected:
 
   double LogLikelihood();
   void InitProb();
-  void EMStep();
+  void EStep(uint32_t d, uint32_t w, uint32_t n);
 };
 
 } /* namespace toyml */
@@ -6,9 +6,11 @@
  */
 
 #include "ex_plsa.h"
+#include "squarem.h"
 
 #include <omp.h>
 #include <iomanip>
+#include <algorithm>
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
 
@@ -62,7 +64,13 @@ bool ExPLSA::Init(const ExPLSAOptions& options, const DocumentSet& document_data
   p_c_u_new_vec_.resize(opts_.threads, ublas::matrix<double>(nc_, nu_, 0));
   p_t_c_new_vec_.resize(opts_.threads, ublas::matrix<double>(nt_, nc_));
   p_w_t_new_vec_.resize(opts_.threads, ublas::matrix<double>(nw_, nt_));
-  p_ct_vec_.resize(opts_.threads, ublas::matrix<double>(nc_, nt_));
+  max_fol_ = 1;
+  for (std::size_t u = 0; u < nu_; ++u) {
+    max_fol_ = std::max<std::size_t>(max_fol_, fdata_->DocLength(u));
+  }
+  p_tc_u_vec_.resize(opts_.threads, std::vector<double>(max_fol_ * nt_));
+  p_t_u_vec_.resize(opts_.threads, std::vector<double>(nt_));
+  r_t_vec_.resize(opts_.threads, std::vector<double>(nt_));
   unorm_vec_.resize(opts_.threads, ublas::vector<double>(nu_));
   cnorm_vec_.resize(opts_.threads, ublas::vector<double>(nc_));
   tnorm_vec_.resize(opts_.threads, ublas::vector<double>(nt_));
@@ -74,14 +82,23 @@ std::size_t ExPLSA::Train() {
   InitProb();
   double pre_lik = LogLikelihood();
   double cur_lik = 0;
+  std::vector<ublas::matrix<double>*> params;
+  params.push_back(&p_c_u_);
+  params.push_back(&p_t_c_);
+  params.push_back(&p_w_t_);
+  Squarem squarem(params, boost::bind(&ExPLSA::EMStep, this), boost::bind(&ExPLSA::LogLikelihood, this));
   VLOG(0) << "[begin] L=" << std::setprecision(10) << pre_lik;
   for (iter_ = 1 ; iter_ <= opts_.niters; ++iter_) {
     LOG_EVERY_N(INFO, opts_.log_interval) << "Iteration#" << iter_;
-    EMStep();
+    if (opts_.accelerate) {
+      cur_lik = squarem.Iterate(pre_lik);
+    } else {
+      EMStep();
+      cur_lik = LogLikelihood();
+    }
     if (iter_ % opts_.save_interval == 0) {
       SaveModel(iter_);
     }
-    cur_lik = LogLikelihood();
     double diff_lik = cur_lik - pre_lik;
     LOG_EVERY_N(INFO, opts_.log_interval) << std::setprecision(10) << "L=" << cur_lik << ", diff=" << diff_lik;
     CHECK(diff_lik >= 0.0);
@@ -92,6 +109,9 @@ std::size_t ExPLSA::Train() {
     pre_lik = cur_lik;
   }
   VLOG(0) << "[end] L=" << std::setprecision(10) << cur_lik;
+  if (opts_.accelerate) {
+    VLOG(0) << "SQUAREM em_steps=" << squarem.em_steps() << ", fallbacks=" << squarem.fallbacks();
+  }
   SaveModel(opts_.finalsuffix);
   return std::min(iter_, opts_.niters);
 }
@@ -112,44 +132,47 @@ bool ExPLSA::SaveModel(const std::string& suffix) const {
 }
 
 bool ExPLSA::SaveTopics(const std::string& path) const {
-  typedef std::pair<double, uint32_t> ProbId;
-
   std::ofstream outf(path.c_str());
   if (!outf) {
     LOG(ERROR) << "Failed to save topics to " << path;
     return false;
   }
 
-  std::vector<ProbId> vec;
-  vec.reserve(nw_);
+  // p(c) = sum_u p(c|u) / N only has terms for the followees of each user,
+  // so it is accumulated over the followee lists once instead of over all
+  // users for every celebrity and topic.
+  ublas::vector<double> p_c(nc_, 0);
+  for (uint32_t u = 0; u < nu_; ++u) {
+    EntryReader fol = fdata_->DocReader(u);
+    for (uint32_t c, n; fol.Next(&c, &n); ) {
+      p_c(c) += p_c_u_(c, u) / nu_;
+    }
+  }
+  ublas::matrix<double> p_tc(nt_, nc_);
+  for (std::size_t t = 0; t < nt_; ++t) {
+    for (std::size_t c = 0; c < nc_; ++c) {
+      p_tc(t, c) = p_c(c) * p_t_c_(t, c);
+//      p_tc(t, c) = p_t_c_(t, c);
+      VLOG_IF(0, p_tc(t, c) > 1) << "[ERROR] p_tc=" << p_tc(t, c) << ", p_c=" << p_c(c) << ", p_t_c=" << p_t_c_(t, c);
+    }
+  }
+
+  std::vector<std::vector<Utils::ProbId> > word_tops;
+  std::vector<std::vector<Utils::ProbId> > cel_tops;
+  Utils::TopK(p_w_t_, true, opts_.topn, &word_tops);
+  Utils::TopK(p_tc, false, opts_.topn, &cel_tops);
   for (std::size_t t = 0; t < nt_; ++t) {
     outf << "Topic #" << t << ":\n";
 
-    vec.clear();
-    for (std::size_t w = 0; w < nw_; ++w) {
-      vec.push_back(ProbId(p_w_t_(w, t), w));
-    }
-    std::sort(vec.begin(), vec.end(), std::greater<ProbId>());
+    const std::vector<Utils::ProbId>& words = word_tops[t];
     outf << "  Top " << opts_.topn << " words:\n";
-    for (std::size_t i = 0; i < vec.size() && i < opts_.topn; ++i) {
-      outf << "\t" << ddata_->Word(vec[i].second) << "\t" << vec[i].first << "\n";
+    for (std::size_t i = 0; i < words.size(); ++i) {
+      outf << "\t" << ddata_->Word(words[i].second) << "\t" << words[i].first << "\n";
     }
 
-    vec.clear();
-    for (std::size_t c = 0; c < nc_; ++c) {
-      double p_c = 0;
-      for (std::size_t u = 0; u < nu_; ++u) {
-        p_c += p_c_u_(c, u) / nu_;
-        VLOG_IF(0, p_c > 1) << "p_c=" << p_c << ", p_c_u_=" << p_c_u_(c, u) << ", c=" << c << ", u=" << u;
-      }
-      double p_tc = p_c * p_t_c_(t, c);
-//      double p_tc = p_t_c_(t, c);
-      VLOG_IF(0, p_tc > 1) << "[ERROR] p_tc=" << p_tc << ", p_c=" << p_c << ", p_t_c=" << p_t_c_(t, c);
-      vec.push_back(ProbId(p_tc, c));
-    }
-    std::sort(vec.begin(), vec.end(), std::greater<ProbId>());
+    const std::vector<Utils::ProbId>& vec = cel_tops[t];
     outf << "  Top " << opts_.topn << " celebrities:\n";
-    for (std::size_t i = 0; i < vec.size() && i < opts_.topn; ++i) {
+    for (std::size_t i = 0; i < vec.size(); ++i) {
       std::string twitter_id = fdata_->Word(vec[i].second);
       outf << "\t" << twitter_id << "\t" << vec[i].first << "\n";
       VLOG_IF(0, vec[i].first > 1) << "t=" << t << ", i=" << i << ", vec[i].first=" << vec[i].first;
@@ -173,27 +196,41 @@ bool ExPLSA::SaveCUModel(const std::string& path) const {
   return SaveModel(path, p_c_u_, nc_, nu_);
 }
 
+void ExPLSA::UserMixture(uint32_t u, double* p_tc_u, double* p_t_u) const {
+  EntryReader fol = fdata_->DocReader(u);
+  std::fill(p_t_u, p_t_u + nt_, 0.0);
+  for (uint32_t fi = 0, c, n; fol.Next(&c, &n); ++fi) {
+    double p_c = p_c_u_(c, u);
+    double* p_t = p_tc_u + fi * nt_;
+    for (uint32_t t = 0; t < nt_; ++t) {
+      p_t[t] = p_t_c_(t, c) * p_c;
+      p_t_u[t] += p_t[t];
+    }
+  }
+}
+
 double ExPLSA::LogLikelihood() {
   VLOG(2) << "LogLikelihood";
   double lik = 0;
-#pragma omp parallel for reduction(+: lik)
-  for (uint32_t u = 0; u < nu_; ++u) {
-    VLOG_IF(3, u % opts_.em_log_interval == 0) << "user#" << u;
-    const Document& doc = ddata_->Doc(u);
-    const Document& fol = fdata_->Doc(u);
-    for (uint32_t p = 0; p < doc.Size(); ++p) {
-      uint32_t w = doc.Word(p);
-      uint32_t n = doc.Freq(p);
-      double p_w_u = 0;
-      for (std::size_t fi = 0; fi < fol.Size(); ++fi) {
-        uint32_t c = fol.Word(fi);
+#pragma omp parallel reduction(+: lik)
+  {
+    std::vector<double> p_tc_u(max_fol_ * nt_);
+    std::vector<double> p_t_u(nt_);
+#pragma omp for
+    for (uint32_t u = 0; u < nu_; ++u) {
+      VLOG_IF(3, u % opts_.em_log_interval == 0) << "user#" << u;
+      EntryReader doc = ddata_->DocReader(u);
+      UserMixture(u, &p_tc_u[0], &p_t_u[0]);
+      for (uint32_t w, n; doc.Next(&w, &n); ) {
+        const double* p_w = &p_w_t_(w, 0);
+        double p_w_u = 0;
         for (uint32_t t = 0; t < nt_; ++t) {
-          p_w_u += p_w_t_(w, t) * p_t_c_(t, c) * p_c_u_(c, u);
+          p_w_u += p_w[t] * p_t_u[t];
         }
-      }
-      if (p_w_u > 0) {
+        if (p_w_u > 0) {
 //        lik += ((1 - p_zuw_(u, w)) * log(p_w_u * lambada_) + p_zuw_(u, w) * log(p_w_b_(w) * (1 - lambada_))) * n;
-        lik += n * log(p_w_u * (1 - lambda_) + p_w_b_(w) * lambda_);
+          lik += n * log(p_w_u * (1 - lambda_) + p_w_b_(w) * lambda_);
+        }
       }
     }
   }
@@ -215,10 +252,9 @@ void ExPLSA::InitProb() {
 
   double norm = 0;
   for (std::size_t u = 0; u < nu_; ++u) {
-    const Document& fol = fdata_->Doc(u);
+    EntryReader fol = fdata_->DocReader(u);
     norm = 0;
-    for (std::size_t i = 0; i < fol.Size(); ++i) {
-      uint32_t c = fol.Word(i);
+    for (uint32_t c, n; fol.Next(&c, &n); ) {
       int r = std::rand() % kMod + 1;
       p_c_u_(c, u) = r;
       norm += r;
@@ -226,8 +262,8 @@ void ExPLSA::InitProb() {
     if (opts_.super_celebrity) {
       norm += norm * p_superc_u_ / (1 - p_superc_u_);
     }
-    for (std::size_t i = 0; i < fol.Size(); ++i) {
-      uint32_t c = fol.Word(i);
+    fol = fdata_->DocReader(u);
+    for (uint32_t c, n; fol.Next(&c, &n); ) {
       p_c_u_(c, u) /= norm;
     }
   }
@@ -273,63 +309,67 @@ void ExPLSA::DoEM(std::size_t tid) {
   tnorm_vec_[tid].clear();
   CHECK(unorm_vec_[tid](0) == 0) << " unorm_vec_[tid](0)=" << unorm_vec_[tid](0);
 
-  ublas::matrix<double> p_ct_(nc_, nt_);
+  // The posterior of (c, t) for word w of user u is proportional to
+  // p(w|t) * p(t|c) * p(c|u), so the per-user products p(t|c) * p(c|u) and
+  // their sum over c are computed once per user instead of once per word.
+  // The sufficient statistics of p(t|c) and p(c|u) only depend on w through
+  // r(t) = sum_w n * p(w|t) * (1 - p(B|u,w)) / norm(w), which makes an
+  // iteration O(words * topics + followees * topics) per user.
+  double* p_tc_u = &p_tc_u_vec_[tid][0];
+  double* p_t_u = &p_t_u_vec_[tid][0];
+  double* r_t = &r_t_vec_[tid][0];
   for (uint32_t u = 0; (u = uid_++) < nu_; ) {
     VLOG_IF(3, u % opts_.em_log_interval == 0) << "user#" << u;
-    const Document& doc = ddata_->Doc(u);
-    const Document& fol = fdata_->Doc(u);
-    p_ct_.clear();
-    for (uint32_t p = 0; p < doc.Size(); ++p) {
-      uint32_t w = doc.Word(p);
-      uint32_t n = doc.Freq(p);
+    EntryReader doc = ddata_->DocReader(u);
+    uint32_t nfollows = fdata_->DocLength(u);
+    UserMixture(u, p_tc_u, p_t_u);
+    if (opts_.super_celebrity) {
+      for (uint32_t t = 0; t < nt_; ++t) {
+        p_t_u[t] += p_t_superc_u_;
+      }
+    }
+    std::fill(r_t, r_t + nt_, 0.0);
+    double nfol = nfollows + (opts_.super_celebrity ? 1 : 0);
+    double nwords = doc.Size();
+    for (uint32_t w, n; doc.Next(&w, &n); ) {
+      const double* p_w = &p_w_t_(w, 0);
 
       // Estep
       double norm = 0;
-      for (std::size_t fi = 0; fi < fol.Size(); ++fi) {
-        uint32_t c = fol.Word(fi);
-        for (uint32_t t = 0; t < nt_; ++t) {
-          double p_wtc_u = p_w_t_(w, t) * p_t_c_(t, c) * p_c_u_(c, u);
-          p_ct_(c, t) = p_wtc_u;
-          norm += p_wtc_u;
-        }
-      }
-      if (opts_.super_celebrity) {
-        for (uint32_t t = 0; t < nt_; ++t) {
-          double p_wtc_u = p_w_t_(w, t) * p_t_superc_u_;
-//          p_ct_(c, t) = p_wtc_u;
-          norm += p_wtc_u;
-        }
+      for (uint32_t t = 0; t < nt_; ++t) {
+        norm += p_w[t] * p_t_u[t];
       }
       double p_w_b = lambda_ * p_w_b_(w);
       double p_uw_b = p_w_b / ((1 - lambda_) * norm + p_w_b);
 
       // Mstep
-      for (std::size_t fi = 0; fi < fol.Size(); ++fi) {
-        uint32_t c = fol.Word(fi);
-        for (uint32_t t = 0; t < nt_; ++t) {
-          double p_ct = p_ct_(c, t) / norm;
-          double np = n * p_ct * (1 - p_uw_b);
-          p_c_u_new_vec_[tid](c, u) += np + oc_;
-          p_t_c_new_vec_[tid](t, c) += np + ot_;
-          p_w_t_new_vec_[tid](w, t) += np + ow_;
-          unorm_vec_[tid](u) += np + oc_;
-          cnorm_vec_[tid](c) += np + ot_;
-          tnorm_vec_[tid](t) += np + ow_;
-        }
+      double coef = n * (1 - p_uw_b) / norm;
+      double* p_w_t_new = &p_w_t_new_vec_[tid](w, 0);
+      for (uint32_t t = 0; t < nt_; ++t) {
+        double r = coef * p_w[t];
+        r_t[t] += r;
+        p_w_t_new[t] += r * p_t_u[t] + nfol * ow_;
       }
-      if (opts_.super_celebrity) {
-        for (uint32_t t = 0; t < nt_; ++t) {
-          double p_ct = p_w_t_(w, t) * p_t_superc_u_;
-          p_ct = p_ct / norm;
-          double np = n * p_ct * (1 - p_uw_b);
-//          p_c_u_new_vec_[tid](c, u) += np + oc_;
-//          p_t_c_new_vec_[tid](t, c) += np + ot_;
-          p_w_t_new_vec_[tid](w, t) += np + ow_;
-          unorm_vec_[tid](u) += np + oc_;
-//          cnorm_vec_[tid](c) += np + ot_;
-          tnorm_vec_[tid](t) += np + ow_;
-        }
+    }
+
+    double unorm = 0;
+    for (uint32_t t = 0; t < nt_; ++t) {
+      double np = r_t[t] * p_t_u[t];
+      unorm += np;
+      tnorm_vec_[tid](t) += np + nwords * nfol * ow_;
+    }
+    unorm_vec_[tid](u) += unorm + nwords * nfol * nt_ * oc_;
+    EntryReader fol = fdata_->DocReader(u);
+    for (uint32_t fi = 0, c, n; fol.Next(&c, &n); ++fi) {
+      const double* p_t = p_tc_u + fi * nt_;
+      double cnorm = 0;
+      for (uint32_t t = 0; t < nt_; ++t) {
+        double np = r_t[t] * p_t[t];
+        cnorm += np;
+        p_t_c_new_vec_[tid](t, c) += np + nwords * ot_;
       }
+      p_c_u_new_vec_[tid](c, u) += cnorm + nwords * nt_ * oc_;
+      cnorm_vec_[tid](c) += cnorm + nwords * nt_ * ot_;
     }
   }
 }
@@ -352,9 +392,8 @@ void ExPLSA::EMStep() {
     for (std::size_t tid = 0; tid < opts_.threads; ++tid) {
       norm_sum += unorm_vec_[tid](u);
     }
-    const Document& fol = fdata_->Doc(u);
-    for (std::size_t fi = 0; fi < fol.Size(); ++fi) {
-      uint32_t c = fol.Word(fi);
+    EntryReader fol = fdata_->DocReader(u);
+    for (uint32_t c, n; fol.Next(&c, &n); ) {
       double sum = 0;
       for (std::size_t tid = 0; tid < opts_.threads; ++tid) {
         sum += p_c_u_new_vec_[tid](c, u);
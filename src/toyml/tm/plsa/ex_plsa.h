@@ -10,6 +10,7 @@
 
 #include <cstddef>
 #include <atomic>
+#include <vector>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/io.hpp>
 #include <boost/thread.hpp>
@@ -46,13 +47,14 @@ struct ExPLSAOptions {
   std::string finalsuffix;
   std::string seperator;
   bool random;
+  bool accelerate;  // whether to accelerate EM with SQUAREM
   ExPLSAOptions() :
       niters(100), ntopics(100), lambda(0.8), ow(0.1), ot(50), oc(0.1), super_celebrity(true),
       eps(0.1), log_interval(10), save_interval(10),
       em_log_interval(1000), threads(4), topn(10),
       datadir("./"), topic_path("topics.dat"), wtpath("word-topic-prob.dat"),
       tcpath("topic-cel-prob.dat"), cupath("cel-user-prob.dat"),
-      finalsuffix("final"), seperator("\t"), random(false) {
+      finalsuffix("final"), seperator("\t"), random(false), accelerate(false) {
   }
   std::string ToString() const {
     std::stringstream ss;
@@ -64,7 +66,7 @@ struct ExPLSAOptions {
     ss << NVC_(save_interval);
     ss << NVC_(threads);
     ss << NVC_(topn);
-    ss << NVC_(random) << NVC_(super_celebrity) << NV_(datadir);
+    ss << NVC_(random) << NVC_(accelerate) << NVC_(super_celebrity) << NV_(datadir);
     return ss.str();
   }
 };
@@ -125,7 +127,10 @@ private:
   std::vector<ublas::matrix<double> > p_c_u_new_vec_;
   std::vector<ublas::matrix<double> > p_t_c_new_vec_;
   std::vector<ublas::matrix<double> > p_w_t_new_vec_;
-  std::vector<ublas::matrix<double> > p_ct_vec_;
+  std::size_t max_fol_;  // maximum number of followees of a user
+  std::vector<std::vector<double> > p_tc_u_vec_;  // p(t|c) * p(c|u) of the followees of the current user
+  std::vector<std::vector<double> > p_t_u_vec_;   // sum_c p(t|c) * p(c|u) of the current user
+  std::vector<std::vector<double> > r_t_vec_;     // per-user expected topic counts divided by p(t|u)
   std::vector<ublas::vector<double> > unorm_vec_;
   std::vector<ublas::vector<double> > cnorm_vec_;
   std::vector<ublas::vector<double> > tnorm_vec_;
@@ -136,6 +141,7 @@ private:
   void InitProb();
   void EMStep();
   void DoEM(std::size_t tid);
+  void UserMixture(uint32_t u, double* p_tc_u, double* p_t_u) const;
 
   std::string Path(const std::string& fname, const std::string& suffix) const;
   bool SaveModel(const std::string& path, const ublas::matrix<double>& mat,
@@ -6,21 +6,43 @@
  */
 
 #include "plsa.h"
+#include "squarem.h"
 
 #include <ctime>
+#include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
 #include <functional>
+#include <boost/bind.hpp>
 
 namespace toyml {
 
+PLSA::PLSA() :
+    evaluator_(NULL), eval_interval_(0) {
+}
+
 PLSA::~PLSA() {
 }
 
 bool PLSA::Init(const PLSAOptions& options, const DocumentSet& dataset) {
+  if (options.accelerate && options.block_size > 0) {
+    LOG(ERROR) << "SQUAREM acceleration needs batch EM, block_size=" << options.block_size;
+    return false;
+  }
+  if (options.lazy_interval > 0 && (options.accelerate || options.block_size > 0 || options.prune_after > 0)) {
+    LOG(ERROR) << "Lazy EM needs batch EM without SQUAREM or pruning, " << NVC_(options.block_size)
+        << NVC_(options.accelerate) << NV_(options.prune_after);
+    return false;
+  }
+  if (options.prune_after > 0 && (options.accelerate || options.block_size > 0)) {
+    LOG(ERROR) << "Pruning p(w|z) needs batch EM without SQUAREM, " << NVC_(options.block_size)
+        << NV_(options.accelerate);
+    return false;
+  }
   options_ = options;
   dataset_ = &dataset;
 
@@ -36,6 +58,9 @@ bool PLSA::Init(const PLSAOptions& options, const DocumentSet& dataset) {
   p_d_new_.resize(nd_);
   p_w_z_new_.resize(nw_, nz_);
   p_z_d_new_.resize(nz_, nd_);
+  word_offsets_.clear();
+  topics_.clear();
+  contrib_.clear();
 
   return true;
 }
@@ -44,24 +69,70 @@ std::size_t PLSA::Train() {
   InitProb();
   double pre_lik = LogLikelihood();
   double cur_lik = 0;
+  std::vector<ublas::matrix<double>*> params;
+  params.push_back(&p_z_d_);
+  params.push_back(&p_w_z_);
+  Squarem squarem(params, boost::bind(&PLSA::EMStep, this), boost::bind(&PLSA::LogLikelihood, this));
+  // L visits every document, which would undo the savings of lazy EM, so
+  // lazy EM evaluates L and checks eps every log_interval iterations only
+  bool lazy = options_.lazy_interval > 0 && options_.log_interval > 1;
   VLOG(0) << "[begin] L=" << std::setprecision(10) << pre_lik;
   for (iter_ = 0 ; iter_ < options_.niters; ++iter_) {
     LOG_EVERY_N(INFO, options_.log_interval) << "Iteration#" << iter_;
-    EMStep();
+    if (options_.prune_after > 0 && iter_ > 0 && iter_ % options_.prune_after == 0) {
+      PruneTopics();
+      double lik = LogLikelihood();
+      VLOG(0) << "Iteration#" << iter_ << " pruned p(w|z) to " << topics_.size() << " of " << nw_ * nz_
+          << " entries, L=" << std::setprecision(10) << lik << ", diff=" << lik - pre_lik;
+      pre_lik = lik;
+    }
+    bool check = !lazy || (iter_ + 1) % options_.log_interval == 0;
+    if (options_.accelerate) {
+      cur_lik = squarem.Iterate(pre_lik);
+    } else {
+      EMStep();
+      if (check) {
+        cur_lik = LogLikelihood();
+      }
+    }
     if ((iter_ + 1) % options_.save_interval == 0) {
       SaveModel(iter_ + 1);
     }
-    cur_lik = LogLikelihood();
+    if (evaluator_ && eval_interval_ > 0 && (iter_ + 1) % eval_interval_ == 0) {
+      evaluator_->EvaluateAsync(p_w_z_, iter_ + 1);
+    }
+    if (!check) {
+      continue;
+    }
     double diff_lik = cur_lik - pre_lik;
-    LOG_EVERY_N(INFO, options_.log_interval) << std::setprecision(10) << "L=" << cur_lik << ", diff=" << diff_lik;
-    CHECK(diff_lik >= 0.0);
+    if (lazy) {
+      LOG(INFO) << std::setprecision(10) << "L=" << cur_lik << ", diff=" << diff_lik;
+    } else {
+      LOG_EVERY_N(INFO, options_.log_interval) << std::setprecision(10) << "L=" << cur_lik << ", diff=" << diff_lik;
+    }
+    if (options_.block_size == 0 && options_.lazy_interval == 0) {
+      CHECK(diff_lik >= 0.0);
+    } else if (diff_lik < 0.0) {
+      // Incremental and lazy EM only increase the free energy, not the likelihood
+      LOG(WARNING) << "Iteration#" << iter_ << " decreased L by " << -diff_lik;
+    }
     if (diff_lik < options_.eps) {
       VLOG(0) << "[break] Iteration#" << iter_ << " diff=" << diff_lik << ", eps=" << options_.eps;
       break;
     }
     pre_lik = cur_lik;
   }
+  if (lazy && iter_ == options_.niters && options_.niters % options_.log_interval != 0) {
+    cur_lik = LogLikelihood();
+  }
   VLOG(0) << "[end] L=" << std::setprecision(10) << cur_lik;
+  if (options_.accelerate) {
+    VLOG(0) << "SQUAREM em_steps=" << squarem.em_steps() << ", fallbacks=" << squarem.fallbacks();
+  }
+  if (evaluator_) {
+    evaluator_->Wait();
+    VLOG(0) << "[end] held-out perplexity=" << std::setprecision(10) << evaluator_->Perplexity(p_w_z_);
+  }
   SaveModel(options_.finalsuffix);
   return std::min(iter_ + 1, options_.niters);
 }
@@ -81,25 +152,18 @@ bool PLSA::SaveModel(const std::string& suffix) const {
 }
 
 bool PLSA::SaveTopics(const std::string& path) const {
-  typedef std::pair<double, uint32_t> ProbWord;
-
   std::ofstream outf(path.c_str());
   if (!outf) {
     LOG(ERROR) << "Failed to save topics to " << path;
     return false;
   }
 
-  std::vector<ProbWord> vec;
-  vec.reserve(nw_);
+  std::vector<std::vector<Utils::ProbId> > tops;
+  Utils::TopK(p_w_z_, true, options_.topn, &tops);
   for (std::size_t z = 0; z < nz_; ++z) {
-    vec.clear();
-    for (std::size_t w = 0; w < nw_; ++w) {
-      vec.push_back(ProbWord(p_w_z_(w, z), w));
-    }
-    std::sort(vec.begin(), vec.end(), std::greater<ProbWord>());
-
+    const std::vector<Utils::ProbId>& vec = tops[z];
     outf << "Topic #" << z << ":\n";
-    for (std::size_t i = 0; i < vec.size() && i < options_.topn; ++i) {
+    for (std::size_t i = 0; i < vec.size(); ++i) {
       outf << "\t" << dataset_->Word(vec[i].second) << "\t" << vec[i].first << "\n";
     }
   }
@@ -113,13 +177,17 @@ double PLSA::LogLikelihood() {
   VLOG(2) << "LogLikelihood";
   double lik = 0;
   for (uint32_t d = 0; d < nd_; ++d) {
-    const Document& doc = dataset_->Doc(d);
-    for (uint32_t p = 0; p < doc.Size(); ++p) {
-      uint32_t w = doc.Word(p);
-      uint32_t n = doc.Freq(p);
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
       double p_dw = 0;
-      for (uint32_t z = 0; z < nz_; ++z) {
-        p_dw += p_z_d_(z, d) * p_w_z_(w, z);
+      if (sparse()) {
+        for (std::size_t i = word_offsets_[w]; i < word_offsets_[w + 1]; ++i) {
+          p_dw += p_z_d_(topics_[i], d) * p_w_z_(w, topics_[i]);
+        }
+      } else {
+        for (uint32_t z = 0; z < nz_; ++z) {
+          p_dw += p_z_d_(z, d) * p_w_z_(w, z);
+        }
       }
       VLOG(5) << "d=" << d << ", w=" << w << ", p_dw=" << p_dw;
       if (p_dw > 0) {
@@ -137,30 +205,50 @@ void PLSA::InitProb() {
 
 void PLSA::EMStep() {
   VLOG(2) << "EMStep";
+  if (options_.block_size > 0 && !contrib_.empty()) {
+    IncrementalEMStep();
+    return;
+  }
+  if (options_.lazy_interval > 0 && !contrib_.empty()) {
+    LazyEMStep();
+    return;
+  }
+  if (sparse()) {
+    SparseEMStep();
+    return;
+  }
 
   p_d_new_.clear();
   p_z_new_.clear();
   p_w_z_new_.clear();
   p_z_d_new_.clear();
 
+  if (options_.block_size > 0 || options_.lazy_interval > 0) {
+    changes_.assign(nd_, std::numeric_limits<double>::infinity());
+    ages_.assign(nd_, 0);
+    offsets_.resize(nd_ + 1);
+    offsets_[0] = 0;
+    for (uint32_t d = 0; d < nd_; ++d) {
+      offsets_[d + 1] = offsets_[d] + dataset_->DocLength(d);
+    }
+    contrib_.resize(offsets_[nd_] * nz_);
+  }
+
   for (uint32_t d = 0; d < nd_; ++d) {
-    const Document& doc = dataset_->Doc(d);
-    for (uint32_t p = 0; p < doc.Size(); ++p) {
-      uint32_t w = doc.Word(p);
-      uint32_t n = doc.Freq(p);
-      // Estep
-      double norm = 0;
-      for (uint32_t z = 0; z < nz_; ++z) {
-        double p_zdw = p_z_d_(z, d) * p_w_z_(w, z);
-        p_z_dw_(z) = p_zdw;
-        norm += p_zdw;
-      }
-      for (uint32_t z = 0; z < nz_; ++z) {
-        p_z_dw_(z) /= norm;
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t p = 0, w, n; reader.Next(&w, &n); ++p) {
+      EStep(d, w, n);
+      if (!contrib_.empty()) {
+        float* contrib = &contrib_[(offsets_[d] + p) * nz_];
+        for (uint32_t z = 0; z < nz_; ++z) {
+          // accumulate the stored value so that it cancels exactly later
+          contrib[z] = p_z_dw_(z);
+          p_z_dw_(z) = contrib[z];
+        }
       }
       // Mstep
       for (uint32_t z = 0; z < nz_; ++z) {
-        double np = n * p_z_dw_(z);
+        double np = p_z_dw_(z);
         p_w_z_new_(w, z) += np;
         p_z_d_new_(z, d) += np;
         p_z_new_(z) += np;
@@ -172,17 +260,179 @@ void PLSA::EMStep() {
   Normalize();
 }
 
-void PLSA::Normalize() {
-  for (uint32_t z = 0; z < nz_; ++z) {
-    for (uint32_t w = 0; w < nw_; ++w) {
-      if (p_z_new_(z) > 0) {
-        p_w_z_(w, z) = p_w_z_new_(w, z) / p_z_new_(z);
+void PLSA::IncrementalEMStep() {
+  // Only p_z_new_ changes for every word after a block, so instead of
+  // normalizing all of p(w|z) per block, a block first brings the rows of its
+  // own words up to date. normalized[w] is the last block that did row w.
+  std::vector<uint32_t> normalized(nw_, 0);
+  for (uint32_t begin = 0, block = 1; begin < nd_; begin += options_.block_size, ++block) {
+    uint32_t end = std::min<std::size_t>(begin + options_.block_size, nd_);
+    for (uint32_t d = begin; d < end; ++d) {
+      EntryReader reader = dataset_->DocReader(d);
+      for (uint32_t w, n; reader.Next(&w, &n); ) {
+        if (normalized[w] != block) {
+          NormalizeWord(w);
+          normalized[w] = block;
+        }
+      }
+    }
+    for (uint32_t d = begin; d < end; ++d) {
+      EntryReader reader = dataset_->DocReader(d);
+      p_d_new_(d) = 0;
+      for (uint32_t z = 0; z < nz_; ++z) {
+        p_z_d_new_(z, d) = 0;
+      }
+      for (uint32_t p = 0, w, n; reader.Next(&w, &n); ++p) {
+        EStep(d, w, n);
+        // Mstep: replace the previous contribution of the entry
+        float* contrib = &contrib_[(offsets_[d] + p) * nz_];
+        for (uint32_t z = 0; z < nz_; ++z) {
+          float np = p_z_dw_(z);
+          double delta = static_cast<double>(np) - contrib[z];
+          contrib[z] = np;
+          p_w_z_new_(w, z) += delta;
+          p_z_new_(z) += delta;
+          p_z_d_new_(z, d) += np;
+          p_d_new_(d) += np;
+        }
+      }
+      for (uint32_t z = 0; z < nz_; ++z) {
+        p_z_d_(z, d) = p_d_new_(d) > 0 ? p_z_d_new_(z, d) / p_d_new_(d) : 0;
+      }
+    }
+  }
+  NormalizeTopics();
+}
+
+void PLSA::LazyEMStep() {
+  std::size_t nvisited = 0;
+  for (uint32_t d = 0; d < nd_; ++d) {
+    if (changes_[d] < options_.lazy_tol && ages_[d] + 1 < options_.lazy_interval) {
+      ++ages_[d];
+      continue;
+    }
+    ages_[d] = 0;
+    ++nvisited;
+    EntryReader reader = dataset_->DocReader(d);
+    p_d_new_(d) = 0;
+    for (uint32_t z = 0; z < nz_; ++z) {
+      p_z_d_new_(z, d) = 0;
+    }
+    for (uint32_t p = 0, w, n; reader.Next(&w, &n); ++p) {
+      EStep(d, w, n);
+      // Mstep: replace the previous contribution of the entry
+      float* contrib = &contrib_[(offsets_[d] + p) * nz_];
+      for (uint32_t z = 0; z < nz_; ++z) {
+        float np = p_z_dw_(z);
+        double delta = static_cast<double>(np) - contrib[z];
+        contrib[z] = np;
+        p_w_z_new_(w, z) += delta;
+        p_z_new_(z) += delta;
+        p_z_d_new_(z, d) += np;
+        p_d_new_(d) += np;
+      }
+    }
+    double change = 0;
+    for (uint32_t z = 0; z < nz_; ++z) {
+      double p_zd = p_d_new_(d) > 0 ? p_z_d_new_(z, d) / p_d_new_(d) : 0;
+      change += std::fabs(p_zd - p_z_d_(z, d));
+    }
+    changes_[d] = change;
+  }
+  VLOG(1) << "Iteration#" << iter_ << " lazy EM visited " << nvisited << " of " << nd_ << " documents";
+
+  Normalize();
+}
+
+void PLSA::SparseEMStep() {
+  p_d_new_.clear();
+  p_z_new_.clear();
+  p_z_d_new_.clear();
+  for (uint32_t w = 0; w < nw_; ++w) {
+    for (std::size_t i = word_offsets_[w]; i < word_offsets_[w + 1]; ++i) {
+      p_w_z_new_(w, topics_[i]) = 0;
+    }
+  }
+
+  for (uint32_t d = 0; d < nd_; ++d) {
+    EntryReader reader = dataset_->DocReader(d);
+    for (uint32_t w, n; reader.Next(&w, &n); ) {
+      // p_z_dw_(i) holds the topic topics_[begin + i]
+      std::size_t begin = word_offsets_[w];
+      std::size_t k = word_offsets_[w + 1] - begin;
+      const uint32_t* topics = &topics_[begin];
+      double norm = 0;
+      for (std::size_t i = 0; i < k; ++i) {
+        double p_zdw = p_z_d_(topics[i], d) * p_w_z_(w, topics[i]);
+        p_z_dw_(i) = p_zdw;
+        norm += p_zdw;
+      }
+      if (norm <= 0) continue;
+      for (std::size_t i = 0; i < k; ++i) {
+        double np = n * (p_z_dw_(i) / norm);
+        p_w_z_new_(w, topics[i]) += np;
+        p_z_d_new_(topics[i], d) += np;
+        p_z_new_(topics[i]) += np;
+      }
+      p_d_new_(d) += n;
+    }
+  }
+
+  Normalize();
+}
+
+void PLSA::PruneTopics() {
+  std::vector<std::size_t> word_offsets(1, 0);
+  std::vector<uint32_t> topics;
+  std::vector<double> kept(nz_, 0);
+  for (uint32_t w = 0; w < nw_; ++w) {
+    std::size_t begin = sparse() ? word_offsets_[w] : 0;
+    std::size_t end = sparse() ? word_offsets_[w + 1] : nz_;
+    uint32_t best = sparse() ? topics_[begin] : 0;
+    for (std::size_t i = begin; i < end; ++i) {
+      uint32_t z = sparse() ? topics_[i] : i;
+      if (p_w_z_(w, z) > p_w_z_(w, best)) {
+        best = z;
+      }
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      uint32_t z = sparse() ? topics_[i] : i;
+      if (p_w_z_(w, z) >= options_.prune_tol || z == best) {
+        topics.push_back(z);
+        kept[z] += p_w_z_(w, z);
       } else {
         p_w_z_(w, z) = 0;
       }
-//      CHECK(p_w_z_(w, z) > 0) << "Iter#" << iter_ << " " << NVC_(z) << NVC_(w) << NVC_(p_w_z_new_(w, z)) << NV_(p_z_new_(z));
     }
+    word_offsets.push_back(topics.size());
+  }
+  word_offsets_.swap(word_offsets);
+  topics_.swap(topics);
+
+  for (uint32_t w = 0; w < nw_; ++w) {
+    for (std::size_t i = word_offsets_[w]; i < word_offsets_[w + 1]; ++i) {
+      uint32_t z = topics_[i];
+      if (kept[z] > 0) {
+        p_w_z_(w, z) /= kept[z];
+      }
+    }
+  }
+}
+
+void PLSA::EStep(uint32_t d, uint32_t w, uint32_t n) {
+  double norm = 0;
+  for (uint32_t z = 0; z < nz_; ++z) {
+    double p_zdw = p_z_d_(z, d) * p_w_z_(w, z);
+    p_z_dw_(z) = p_zdw;
+    norm += p_zdw;
   }
+  for (uint32_t z = 0; z < nz_; ++z) {
+    p_z_dw_(z) = n * (p_z_dw_(z) / norm);
+  }
+}
+
+void PLSA::Normalize() {
+  NormalizeTopics();
 
   for (uint32_t d = 0; d < nd_; ++d) {
     for (uint32_t z = 0; z < nz_; ++z) {
@@ -195,6 +445,32 @@ void PLSA::Normalize() {
   }
 }
 
+void PLSA::NormalizeWord(uint32_t w) {
+  for (uint32_t z = 0; z < nz_; ++z) {
+    if (p_z_new_(z) > 0) {
+      // the deltas of incremental EM may leave a tiny negative residue
+      p_w_z_(w, z) = std::max(p_w_z_new_(w, z), 0.0) / p_z_new_(z);
+    } else {
+      p_w_z_(w, z) = 0;
+    }
+  }
+}
+
+void PLSA::NormalizeTopics() {
+  if (sparse()) {
+    for (uint32_t w = 0; w < nw_; ++w) {
+      for (std::size_t i = word_offsets_[w]; i < word_offsets_[w + 1]; ++i) {
+        uint32_t z = topics_[i];
+        p_w_z_(w, z) = p_z_new_(z) > 0 ? p_w_z_new_(w, z) / p_z_new_(z) : 0;
+      }
+    }
+    return;
+  }
+  for (uint32_t w = 0; w < nw_; ++w) {
+    NormalizeWord(w);
+  }
+}
+
 void PLSA::RandomizeMatrix(ublas::matrix<double>& mat) {
   static int kMod = 10000;
   static bool s_srand_done = false;
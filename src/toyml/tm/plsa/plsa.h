@@ -16,6 +16,7 @@
 
 #include <toyml/tm/utils.h>
 #include <toyml/tm/dataset.h>
+#include <toyml/tm/heldout.h>
 
 namespace toyml {
 
@@ -32,6 +33,11 @@ struct PLSAOptions {
   int log_interval;
   int save_interval;
   std::size_t topn;
+  std::size_t block_size;   // documents per p(w|z) update in incremental EM, 0 means batch EM
+  std::size_t prune_after;  // p(w|z) is pruned every prune_after iterations, 0 means never
+  double prune_tol;         // p(w|z) entries below prune_tol are dropped by pruning
+  std::size_t lazy_interval;  // stable documents are revisited every lazy_interval iterations, 0 visits all every iteration
+  double lazy_tol;            // a document is stable when the L1 change of its p(z|d) is below lazy_tol
   std::string datadir;
   std::string topic_path;
   std::string zdpath;
@@ -39,11 +45,13 @@ struct PLSAOptions {
   std::string finalsuffix;
   std::string seperator;
   bool random;
+  bool accelerate;  // whether to accelerate EM with SQUAREM
   PLSAOptions() :
       niters(100), ntopics(30), eps(1e-3), log_interval(10), save_interval(10), topn(10),
-      datadir("./"), topic_path("topics.dat"),
+      block_size(0), prune_after(0), prune_tol(1e-6),
+      lazy_interval(0), lazy_tol(1e-3), datadir("./"), topic_path("topics.dat"),
       zdpath("topic-doc-prob.dat"), wzpath("word-topic-prob.dat"),
-      finalsuffix("final"), seperator("\t"), random(false) {
+      finalsuffix("final"), seperator("\t"), random(false), accelerate(false) {
   }
   std::string ToString() const {
     std::stringstream ss;
@@ -53,7 +61,11 @@ struct PLSAOptions {
     ss << NVC_(log_interval);
     ss << NVC_(save_interval);
     ss << NVC_(topn);
+    ss << NVC_(block_size);
+    ss << NVC_(prune_after) << NVC_(prune_tol);
+    ss << NVC_(lazy_interval) << NVC_(lazy_tol);
     ss << NVC_(random);
+    ss << NVC_(accelerate);
     ss << NV_(datadir);
     return ss.str();
   }
@@ -64,9 +76,18 @@ struct PLSAOptions {
  */
 class PLSA {
 public:
+  PLSA();
   virtual ~PLSA();
   bool Init(const PLSAOptions& options, const DocumentSet& dataset);
+  // Evaluates p(w|z) on evaluator in the background every interval iterations of Train
+  void set_evaluator(HeldoutEvaluator* evaluator, std::size_t interval) {
+    evaluator_ = evaluator;
+    eval_interval_ = interval;
+  }
   std::size_t Train();
+  const ublas::matrix<double>& p_w_z() const {
+    return p_w_z_;
+  }
   bool SaveModel(int no) const;
   bool SaveModel(const std::string& suffix = "") const;
   bool SaveTopics(const std::string& path) const;
@@ -85,22 +106,54 @@ protected:
 
   ublas::matrix<double> p_z_d_;        // p(z|d)
   ublas::matrix<double> p_w_z_;        // p(w|z)
-  ublas::vector<double> p_z_dw_;       // p(z|d,w)
+  ublas::vector<double> p_z_dw_;       // p(z|d,w), or n(d,w) * p(z|d,w) after EStep
 
   ublas::vector<double> p_d_new_;
   ublas::vector<double> p_z_new_;
   ublas::matrix<double> p_z_d_new_;
   ublas::matrix<double> p_w_z_new_;
 
+  // Incremental EM and lazy EM keep the last contribution of every entry to
+  // the accumulators, so that it can be replaced when the entry is revisited
+  std::vector<std::size_t> offsets_;  // offsets_[d]: index of the first entry of document d
+  std::vector<float> contrib_;        // contrib_[(offsets_[d] + p) * nz_ + z]: n(d,w) * p(z|d,w)
+
+  // After pruning, p(w|z) is zero except for the topics
+  // topics_[word_offsets_[w], word_offsets_[w + 1]) of every word w. EM never
+  // revives a zero, so the E-step and M-step only visit these topics.
+  std::vector<std::size_t> word_offsets_;
+  std::vector<uint32_t> topics_;
+
+  // Lazy EM skips the stable documents, whose cached contributions stay in the accumulators
+  std::vector<double> changes_;     // changes_[d]: L1 change of p(z|d) at the last visit of d
+  std::vector<std::size_t> ages_;   // ages_[d]: iterations since the last visit of d
+
   std::size_t iter_;    // current iteration
 
+  HeldoutEvaluator* evaluator_;
+  std::size_t eval_interval_;
+
   void RandomizeMatrix(ublas::matrix<double>& mat);
   bool SaveMatrix(const ublas::matrix<double>& mat, const std::string& path) const;
 
   virtual double LogLikelihood();
   virtual void InitProb();
   virtual void EMStep();
+  // Computes the expected counts n(d,w) * p(z|d,w) of word w in document d into p_z_dw_
+  virtual void EStep(uint32_t d, uint32_t w, uint32_t n);
   virtual void Normalize();
+  void NormalizeTopics();
+  // p(w|z) of word w from the accumulators
+  void NormalizeWord(uint32_t w);
+  void IncrementalEMStep();
+  void LazyEMStep();
+  bool sparse() const {
+    return !word_offsets_.empty();
+  }
+  // Drops the p(w|z) below options.prune_tol, keeping at least the largest
+  // one of every word, and renormalizes the topics
+  void PruneTopics();
+  void SparseEMStep();
 
   std::string Path(const std::string& fname, const std::string& suffix) const;
 };
@@ -6,7 +6,127 @@
  */
 
 #include "plsa.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <gtest/gtest.h>
 
 namespace toyml {
 
+/**
+ * @brief Runs the EM steps of pLSA without saving the model
+ */
+class EMRunner : public PLSA {
+public:
+  void Start() {
+    std::srand(0);
+    InitProb();
+    iter_ = 0;
+  }
+  void Run(std::size_t iters) {
+    for (std::size_t i = 0; i < iters; ++i, ++iter_) {
+      EMStep();
+    }
+  }
+  void Prune() {
+    PruneTopics();
+  }
+  bool sparse() const {
+    return PLSA::sparse();
+  }
+  std::size_t nentries() const {
+    return topics_.size();
+  }
+  // number of documents skipped by the last lazy EM step
+  std::size_t nskipped() const {
+    return ages_.size() - std::count(ages_.begin(), ages_.end(), 0U);
+  }
+  double Likelihood() {
+    return LogLikelihood();
+  }
+  const ublas::matrix<double>& p_z_d() const {
+    return p_z_d_;
+  }
+};
+
+class PLSATest: public testing::Test {
+protected:
+  virtual void SetUp() {
+    std::stringstream ss;
+    for (int i = 0; i < 7; ++i) {
+      ss << "apple banana cherry apple\n";
+      ss << "dog eel fox dog eel\n";
+      ss << "apple dog cherry fox\n";
+    }
+    ASSERT_EQ(21U, dataset_.LoadNext(ss, 100));
+    options_.ntopics = 3;
+  }
+
+  void ExpectNear(const EMRunner& expected, const EMRunner& actual, double tol) {
+    for (uint32_t w = 0; w < dataset_.DictSize(); ++w) {
+      for (uint32_t z = 0; z < options_.ntopics; ++z) {
+        EXPECT_NEAR(expected.p_w_z()(w, z), actual.p_w_z()(w, z), tol) << NVC_(w) << NV_(z);
+      }
+    }
+    for (uint32_t z = 0; z < options_.ntopics; ++z) {
+      for (uint32_t d = 0; d < dataset_.DocSize(); ++d) {
+        EXPECT_NEAR(expected.p_z_d()(z, d), actual.p_z_d()(z, d), tol) << NVC_(z) << NV_(d);
+      }
+    }
+  }
+
+  DocumentSet dataset_;
+  PLSAOptions options_;
+};
+
+// With prune_tol=0 pruning keeps every entry, so the sparse E-step, M-step
+// and LogLikelihood must reproduce dense EM
+TEST_F(PLSATest, SparseMatchesDenseWithoutPruning) {
+  EMRunner dense;
+  ASSERT_TRUE(dense.Init(options_, dataset_));
+  options_.prune_after = 1;
+  options_.prune_tol = 0;
+  EMRunner sparse;
+  ASSERT_TRUE(sparse.Init(options_, dataset_));
+
+  dense.Start();
+  dense.Run(2);
+  sparse.Start();
+  sparse.Run(2);
+  sparse.Prune();
+  ASSERT_TRUE(sparse.sparse());
+  EXPECT_EQ(dataset_.DictSize() * options_.ntopics, sparse.nentries());
+  ExpectNear(dense, sparse, 1e-15);
+
+  for (int iter = 0; iter < 5; ++iter) {
+    double lik = dense.Likelihood();
+    EXPECT_NEAR(lik, sparse.Likelihood(), 1e-12 * std::fabs(lik)) << "iteration " << iter;
+    dense.Run(1);
+    sparse.Run(1);
+  }
+  ExpectNear(dense, sparse, 1e-12);
+}
+
+// With lazy_tol=0 no document is ever stable, so lazy EM visits every
+// document and only differs from batch EM by its float contributions
+TEST_F(PLSATest, LazyMatchesBatchWithZeroTolerance) {
+  EMRunner batch;
+  ASSERT_TRUE(batch.Init(options_, dataset_));
+  options_.lazy_interval = 3;
+  options_.lazy_tol = 0;
+  EMRunner lazy;
+  ASSERT_TRUE(lazy.Init(options_, dataset_));
+
+  batch.Start();
+  lazy.Start();
+  for (int iter = 0; iter < 10; ++iter) {
+    batch.Run(1);
+    lazy.Run(1);
+    EXPECT_EQ(0U, lazy.nskipped()) << "iteration " << iter;
+    double lik = batch.Likelihood();
+    EXPECT_NEAR(lik, lazy.Likelihood(), 1e-6 * std::fabs(lik)) << "iteration " << iter;
+  }
+  ExpectNear(batch, lazy, 1e-5);
+}
+
 } /* namespace toyml */
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "squarem.h"
+
+#include <cmath>
+#include <algorithm>
+#include <glog/logging.h>
+
+namespace toyml {
+
+// Extrapolated entries below this fraction of their value after the second EM
+// step are raised to it, since EM can never move an entry away from zero
+static const double kFloor = 1e-3;
+
+Squarem::Squarem(const std::vector<ublas::matrix<double>*>& params,
+    const EMStep& em_step, const LogLikelihood& loglik) :
+    params_(params), em_step_(em_step), loglik_(loglik),
+    theta0_(params.size()), r_(params.size()), theta2_(params.size()),
+    em_steps_(0), fallbacks_(0) {
+}
+
+Squarem::~Squarem() {
+}
+
+double Squarem::Iterate(double lik) {
+  for (std::size_t i = 0; i < params_.size(); ++i) {
+    theta0_[i] = *params_[i];
+  }
+  Step();
+  for (std::size_t i = 0; i < params_.size(); ++i) {
+    r_[i] = *params_[i] - theta0_[i];
+  }
+  Step();
+
+  // v = theta2 - 2 * theta1 + theta0 = theta2 - theta0 - 2 * r
+  double r2 = 0;
+  double v2 = 0;
+  for (std::size_t i = 0; i < params_.size(); ++i) {
+    theta2_[i] = *params_[i];
+    const ublas::matrix<double>& theta0 = theta0_[i];
+    const ublas::matrix<double>& r = r_[i];
+    const ublas::matrix<double>& theta2 = theta2_[i];
+    for (std::size_t y = 0; y < r.size1(); ++y) {
+      for (std::size_t x = 0; x < r.size2(); ++x) {
+        double v = theta2(y, x) - theta0(y, x) - 2 * r(y, x);
+        r2 += r(y, x) * r(y, x);
+        v2 += v * v;
+      }
+    }
+  }
+  if (r2 == 0 || v2 == 0) {
+    return loglik_();
+  }
+
+  // alpha = -1 is the second EM step itself
+  double alpha = std::min(-std::sqrt(r2 / v2), -1.0);
+  Extrapolate(alpha);
+  Step();
+  double new_lik = loglik_();
+  VLOG(2) << "SQUAREM alpha=" << alpha << ", L=" << new_lik;
+  if (new_lik < lik) {
+    VLOG(1) << "SQUAREM falls back to EM, alpha=" << alpha;
+    ++fallbacks_;
+    for (std::size_t i = 0; i < params_.size(); ++i) {
+      *params_[i] = theta2_[i];
+    }
+    new_lik = loglik_();
+  }
+  return new_lik;
+}
+
+void Squarem::Step() {
+  em_step_();
+  ++em_steps_;
+}
+
+void Squarem::Extrapolate(double alpha) {
+  // theta' = theta0 - 2 * alpha * r + alpha^2 * v
+  for (std::size_t i = 0; i < params_.size(); ++i) {
+    ublas::matrix<double>& param = *params_[i];
+    const ublas::matrix<double>& theta0 = theta0_[i];
+    const ublas::matrix<double>& r = r_[i];
+    const ublas::matrix<double>& theta2 = theta2_[i];
+    std::vector<double> sums(param.size2(), 0);
+    std::vector<double> new_sums(param.size2(), 0);
+    for (std::size_t y = 0; y < param.size1(); ++y) {
+      for (std::size_t x = 0; x < param.size2(); ++x) {
+        double v = theta2(y, x) - theta0(y, x) - 2 * r(y, x);
+        double value = theta0(y, x) - 2 * alpha * r(y, x) + alpha * alpha * v;
+        value = std::max(value, kFloor * theta2(y, x));
+        param(y, x) = value;
+        sums[x] += theta2(y, x);
+        new_sums[x] += value;
+      }
+    }
+    for (std::size_t x = 0; x < param.size2(); ++x) {
+      sums[x] = new_sums[x] > 0 ? sums[x] / new_sums[x] : 0;
+    }
+    for (std::size_t y = 0; y < param.size1(); ++y) {
+      for (std::size_t x = 0; x < param.size2(); ++x) {
+        param(y, x) *= sums[x];
+      }
+    }
+  }
+}
+
+} /* namespace toyml */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef SQUAREM_H_
+#define SQUAREM_H_
+
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+
+namespace toyml {
+
+namespace ublas = boost::numeric::ublas;
+
+/**
+ * @brief SQUAREM acceleration of an EM algorithm (Varadhan & Roland, 2008)
+ *
+ * An iteration takes two EM steps from theta0, extrapolates along them with
+ * the step length alpha = -|r|/|v| of scheme S3, projects the result back to
+ * non-negative columns and stabilizes it with a third EM step. If this ends
+ * with a lower log-likelihood than theta0, the iteration falls back to the
+ * second EM step, so the log-likelihood never decreases.
+ *
+ * The parameters are matrices whose columns are (sub-)distributions: the
+ * projection keeps zeros, and rescales every column to its sum after the
+ * second EM step.
+ */
+class Squarem {
+public:
+  typedef boost::function<void ()> EMStep;
+  typedef boost::function<double ()> LogLikelihood;
+
+  Squarem(const std::vector<ublas::matrix<double>*>& params,
+      const EMStep& em_step, const LogLikelihood& loglik);
+  virtual ~Squarem();
+
+  // Runs an iteration from the current parameters whose log-likelihood is lik,
+  // and returns the log-likelihood of the new parameters
+  double Iterate(double lik);
+  // number of EM steps taken
+  std::size_t em_steps() const {
+    return em_steps_;
+  }
+  // number of iterations that fell back to plain EM
+  std::size_t fallbacks() const {
+    return fallbacks_;
+  }
+private:
+  std::vector<ublas::matrix<double>*> params_;
+  EMStep em_step_;
+  LogLikelihood loglik_;
+
+  std::vector<ublas::matrix<double> > theta0_;
+  std::vector<ublas::matrix<double> > r_;
+  std::vector<ublas::matrix<double> > theta2_;
+
+  std::size_t em_steps_;
+  std::size_t fallbacks_;
+
+  void Step();
+  void Extrapolate(double alpha);
+};
+
+} /* namespace toyml */
+#endif /* SQUAREM_H_ */
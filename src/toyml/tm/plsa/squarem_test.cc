@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "squarem.h"
+#include <algorithm>
+#include <boost/ref.hpp>
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+/**
+ * @brief EM step that halves the distance of a 2 x 1 distribution to (0.8, 0.2)
+ */
+struct HalfwayStep {
+  ublas::matrix<double>* theta;
+  void operator()() {
+    (*theta)(0, 0) += 0.5 * (0.8 - (*theta)(0, 0));
+    (*theta)(1, 0) += 0.5 * (0.2 - (*theta)(1, 0));
+  }
+};
+
+/**
+ * @brief Log-likelihood returning scripted values
+ */
+struct ScriptedLikelihood {
+  std::vector<double> values;
+  std::size_t calls;
+  double operator()() {
+    return values[std::min(calls++, values.size() - 1)];
+  }
+};
+
+class SquaremTest : public testing::Test {
+protected:
+  ublas::matrix<double> theta_;
+  HalfwayStep step_;
+  ScriptedLikelihood lik_;
+  std::vector<ublas::matrix<double>*> params_;
+
+  virtual void SetUp() {
+    theta_ = ublas::matrix<double>(2, 1);
+    theta_(0, 0) = 0.5;
+    theta_(1, 0) = 0.5;
+    step_.theta = &theta_;
+    lik_.calls = 0;
+    params_.push_back(&theta_);
+  }
+};
+
+TEST_F(SquaremTest, Extrapolates) {
+  lik_.values.push_back(0);
+  Squarem squarem(params_, boost::ref(step_), boost::ref(lik_));
+  EXPECT_DOUBLE_EQ(0, squarem.Iterate(-1));
+  // the step length of a linear contraction lands on its fixed point
+  EXPECT_NEAR(0.8, theta_(0, 0), 1e-12);
+  EXPECT_NEAR(0.2, theta_(1, 0), 1e-12);
+  EXPECT_EQ(3U, squarem.em_steps());
+  EXPECT_EQ(0U, squarem.fallbacks());
+}
+
+TEST_F(SquaremTest, FallsBackWhenLikelihoodDrops) {
+  lik_.values.push_back(-10);
+  lik_.values.push_back(-0.5);
+  Squarem squarem(params_, boost::ref(step_), boost::ref(lik_));
+  EXPECT_DOUBLE_EQ(-0.5, squarem.Iterate(-1));
+  // the parameters after the two plain EM steps
+  EXPECT_DOUBLE_EQ(0.725, theta_(0, 0));
+  EXPECT_DOUBLE_EQ(0.275, theta_(1, 0));
+  EXPECT_EQ(3U, squarem.em_steps());
+  EXPECT_EQ(1U, squarem.fallbacks());
+  EXPECT_EQ(2U, lik_.calls);
+}
+
+} /* namespace toyml */
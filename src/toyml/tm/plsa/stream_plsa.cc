@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "stream_plsa.h"
+
+#include <cmath>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+
+#include <toyml/util/mapped_file.h>
+
+namespace toyml {
+
+StreamPLSA::~StreamPLSA() {
+}
+
+bool StreamPLSA::Init(const StreamPLSAOptions& options, const std::string& docpath) {
+  CHECK_GT(options.shard_size, 0);
+  if (options.block_size > 0 || options.accelerate) {
+    LOG(ERROR) << "Neither incremental nor accelerated EM is supported out of core";
+    return false;
+  }
+  if (options.prune_after > 0 || options.lazy_interval > 0) {
+    LOG(ERROR) << "Neither sparse nor lazy EM is supported out of core";
+    return false;
+  }
+  options_ = options;
+  soptions_ = options;
+  dataset_ = &shard_;
+
+  if (!Scan(docpath)) {
+    return false;
+  }
+
+  nd_ = 0;
+  for (std::size_t s = 0; s < shard_docs_.size(); ++s) {
+    nd_ += shard_docs_[s];
+  }
+  nw_ = shard_.DictSize();
+  nz_ = options_.ntopics;
+
+  p_w_z_.resize(nw_, nz_);
+  p_z_dw_.resize(nz_);
+  p_z_new_.resize(nz_);
+  p_w_z_new_.resize(nw_, nz_);
+  p_z_d_new_doc_.resize(nz_);
+  lik_ = 0;
+  return true;
+}
+
+bool StreamPLSA::Scan(const std::string& docpath) {
+  shard_.Clear();
+  shard_docs_.clear();
+  std::ifstream inf(docpath.c_str(), std::ios::binary);
+  if (!inf) {
+    LOG(ERROR) << "Failed to open " << docpath;
+    return false;
+  }
+
+  if (soptions_.binary) {
+    if (!shard_.LoadDict(soptions_.dictpath)) {
+      LOG(ERROR) << "Failed to load dictionary " << soptions_.dictpath;
+      return false;
+    }
+    corpus_ = docpath;
+    while (std::size_t n = shard_.LoadNextBinary(inf, soptions_.shard_size)) {
+      shard_docs_.push_back(n);
+    }
+  } else {
+    corpus_ = soptions_.swapdir + "/corpus.bin";
+    std::ofstream outf(corpus_.c_str(), std::ios::binary);
+    if (!outf) {
+      LOG(ERROR) << "Failed to create " << corpus_;
+      return false;
+    }
+    while (std::size_t n = shard_.LoadNext(inf, soptions_.shard_size)) {
+      if (!shard_.WriteBinary(outf)) {
+        LOG(ERROR) << "Failed to write " << corpus_;
+        return false;
+      }
+      shard_docs_.push_back(n);
+    }
+  }
+  VLOG(0) << "Scanned " << docpath << ": shards=" << shard_docs_.size()
+      << ", DicSize=" << shard_.DictSize();
+  return true;
+}
+
+std::size_t StreamPLSA::Train() {
+  InitProb();
+  double pre_lik = 0;
+  double cur_lik = 0;
+  for (iter_ = 0; iter_ < options_.niters; ++iter_) {
+    LOG_EVERY_N(INFO, options_.log_interval) << "Iteration#" << iter_;
+    EMStep();
+    if ((iter_ + 1) % options_.save_interval == 0) {
+      SaveModel(iter_ + 1);
+    }
+    cur_lik = lik_;
+    if (iter_ == 0) {
+      VLOG(0) << "[begin] L=" << std::setprecision(10) << cur_lik;
+      pre_lik = cur_lik;
+      continue;
+    }
+    // lik_ lags one iteration behind, so diff_lik is the gain of the previous one
+    double diff_lik = cur_lik - pre_lik;
+    LOG_EVERY_N(INFO, options_.log_interval) << std::setprecision(10) << "L=" << cur_lik << ", diff=" << diff_lik;
+    CHECK(diff_lik >= 0.0);
+    if (diff_lik < options_.eps) {
+      VLOG(0) << "[break] Iteration#" << iter_ << " diff=" << diff_lik << ", eps=" << options_.eps;
+      break;
+    }
+    pre_lik = cur_lik;
+  }
+  VLOG(0) << "[end] L=" << std::setprecision(10) << cur_lik;
+  SaveModel(options_.finalsuffix);
+  return std::min(iter_ + 1, options_.niters);
+}
+
+void StreamPLSA::InitProb() {
+  // Randomize shard by shard in document order, which draws the same random
+  // numbers as PLSA::InitProb does for the whole p(z|d)
+  for (std::size_t s = 0; s < shard_docs_.size(); ++s) {
+    ublas::matrix<double> p_z_d(nz_, shard_docs_[s]);
+    RandomizeMatrix(p_z_d);
+    MappedFile file;
+    CHECK(file.Create(ShardPath(s), nz_ * shard_docs_[s] * sizeof(double)))
+        << "Failed to create " << ShardPath(s);
+    double* zd = reinterpret_cast<double*>(file.mutable_data());
+    for (std::size_t d = 0; d < shard_docs_[s]; ++d) {
+      for (std::size_t z = 0; z < nz_; ++z) {
+        zd[d * nz_ + z] = p_z_d(z, d);
+      }
+    }
+  }
+  RandomizeMatrix(p_w_z_);
+}
+
+void StreamPLSA::EMStep() {
+  VLOG(2) << "EMStep";
+
+  p_z_new_.clear();
+  p_w_z_new_.clear();
+  lik_ = 0;
+
+  std::ifstream inf(corpus_.c_str(), std::ios::binary);
+  CHECK(inf) << "Failed to open " << corpus_;
+  for (std::size_t s = 0; s < shard_docs_.size(); ++s) {
+    CHECK_EQ(shard_.LoadNextBinary(inf, soptions_.shard_size), shard_docs_[s])
+        << "Corpus " << corpus_ << " changed since Init";
+    MappedFile file;
+    CHECK(file.OpenWritable(ShardPath(s))) << "Failed to map " << ShardPath(s);
+    double* zd = reinterpret_cast<double*>(file.mutable_data());
+
+    for (uint32_t d = 0; d < shard_docs_[s]; ++d) {
+      const Document& doc = shard_.Doc(d);
+      double* p_z_d = zd + d * nz_;
+      double p_d_new = 0;
+      p_z_d_new_doc_.clear();
+      for (uint32_t p = 0; p < doc.Size(); ++p) {
+        uint32_t w = doc.Word(p);
+        uint32_t n = doc.Freq(p);
+        // Estep
+        double norm = 0;
+        for (uint32_t z = 0; z < nz_; ++z) {
+          double p_zdw = p_z_d[z] * p_w_z_(w, z);
+          p_z_dw_(z) = p_zdw;
+          norm += p_zdw;
+        }
+        if (norm > 0) {
+          lik_ += n * log(norm);
+        }
+        for (uint32_t z = 0; z < nz_; ++z) {
+          p_z_dw_(z) /= norm;
+        }
+        // Mstep
+        for (uint32_t z = 0; z < nz_; ++z) {
+          double np = n * p_z_dw_(z);
+          p_w_z_new_(w, z) += np;
+          p_z_d_new_doc_(z) += np;
+          p_z_new_(z) += np;
+          p_d_new += np;
+        }
+      }
+      // p(z|d) only depends on the document itself, so it is final already
+      for (uint32_t z = 0; z < nz_; ++z) {
+        p_z_d[z] = p_d_new > 0 ? p_z_d_new_doc_(z) / p_d_new : 0;
+      }
+    }
+  }
+
+  Normalize();
+}
+
+void StreamPLSA::Normalize() {
+  for (uint32_t z = 0; z < nz_; ++z) {
+    for (uint32_t w = 0; w < nw_; ++w) {
+      if (p_z_new_(z) > 0) {
+        p_w_z_(w, z) = p_w_z_new_(w, z) / p_z_new_(z);
+      } else {
+        p_w_z_(w, z) = 0;
+      }
+    }
+  }
+}
+
+bool StreamPLSA::SaveModel(int no) const {
+  std::stringstream ss;
+  ss << no;
+  return SaveModel(ss.str());
+}
+
+bool StreamPLSA::SaveModel(const std::string& suffix) const {
+  VLOG(1) << "SaveModel suffix=" << suffix;
+  bool ret = SaveTopics(Path(options_.topic_path, suffix));
+  ret &= SaveMatrix(p_w_z_, Path(options_.wzpath, suffix));
+
+  // Same format as SaveMatrix(p_z_d_, ...), streamed from the shards
+  std::string path = Path(options_.zdpath, suffix);
+  std::ofstream outf(path.c_str());
+  if (!outf) {
+    LOG(ERROR) << "Failed to save matrix to " << path;
+    return false;
+  }
+  outf << nd_ << options_.seperator << nz_ << "\n";
+  for (std::size_t s = 0; s < shard_docs_.size(); ++s) {
+    MappedFile file;
+    if (!file.Open(ShardPath(s))) {
+      LOG(ERROR) << "Failed to map " << ShardPath(s);
+      return false;
+    }
+    const double* zd = reinterpret_cast<const double*>(file.data());
+    for (std::size_t d = 0; d < shard_docs_[s]; ++d) {
+      for (std::size_t z = 0; z < nz_; ++z) {
+        outf << zd[d * nz_ + z] << options_.seperator;
+      }
+      outf << "\n";
+    }
+  }
+  outf.close();
+  VLOG(2) << "Have saved matrix to " << path;
+  return ret;
+}
+
+std::string StreamPLSA::ShardPath(std::size_t shard) const {
+  std::stringstream ss;
+  ss << soptions_.swapdir << "/p_z_d." << shard << ".bin";
+  return ss.str();
+}
+
+} /* namespace toyml */
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef STREAM_PLSA_H_
+#define STREAM_PLSA_H_
+
+#include <vector>
+
+#include "plsa.h"
+
+namespace toyml {
+
+/**
+ * @brief out-of-core pLSA options
+ */
+struct StreamPLSAOptions : public PLSAOptions {
+  std::size_t shard_size;  // number of documents of each shard
+  std::string swapdir;     // directory of the paged p(z|d) files and the binary corpus
+  bool binary;             // whether the corpus is written by DocumentSet::WriteBinary
+  std::string dictpath;    // dictionary written by DocumentSet::SaveDict, required by a binary corpus
+  StreamPLSAOptions() :
+      shard_size(100000), swapdir("./"), binary(false) {
+  }
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << PLSAOptions::ToString() << ", ";
+    ss << NVC_(shard_size);
+    ss << NVC_(swapdir);
+    ss << NV_(binary);
+    return ss.str();
+  }
+};
+
+/**
+ * @brief pLSA that streams the corpus from disk in shards
+ *
+ * Only p(w|z) and its accumulators are resident. Every EM iteration reads the
+ * corpus shard by shard from a binary file and updates p(z|d) of the shard in
+ * place in a memory-mapped file, so memory is bounded by the vocabulary and
+ * the shard size. A text corpus is converted to the binary format while the
+ * dictionary is built.
+ *
+ * The log-likelihood is computed in the same pass as the E-step, so it is the
+ * likelihood of the parameters an iteration starts from.
+ */
+class StreamPLSA : public PLSA {
+public:
+  virtual ~StreamPLSA();
+  bool Init(const StreamPLSAOptions& options, const std::string& docpath);
+  std::size_t Train();
+  bool SaveModel(int no) const;
+  bool SaveModel(const std::string& suffix = "") const;
+  const DocumentSet& dataset() const {
+    return shard_;
+  }
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << PLSA::ToString() << ", " << NV_(shard_docs_.size());
+    return ss.str();
+  }
+protected:
+  StreamPLSAOptions soptions_;
+  DocumentSet shard_;                     // dictionary and documents of the current shard
+  std::string corpus_;                    // path of the binary corpus
+  std::vector<std::size_t> shard_docs_;   // number of documents of each shard
+  ublas::vector<double> p_z_d_new_doc_;
+  double lik_;    // log-likelihood of the parameters before the last EMStep
+
+  virtual void InitProb();
+  virtual void EMStep();
+  virtual void Normalize();
+
+  bool Scan(const std::string& docpath);
+  std::string ShardPath(std::size_t shard) const;
+};
+
+} /* namespace toyml */
+#endif /* STREAM_PLSA_H_ */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "stream_plsa.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+/**
+ * @brief Runs the EM steps of a pLSA model without saving it
+ */
+template<typename Model>
+class EMRunner : public Model {
+public:
+  void Run(std::size_t iters) {
+    std::srand(0);
+    this->InitProb();
+    for (this->iter_ = 0; this->iter_ < iters; ++this->iter_) {
+      Step();
+    }
+  }
+  void Step() {
+    this->EMStep();
+  }
+  double Likelihood() {
+    return this->LogLikelihood();
+  }
+  // log-likelihood of the parameters before the last EMStep of StreamPLSA
+  double lik() const {
+    return this->lik_;
+  }
+};
+
+TEST(StreamPLSA, MatchesInCorePLSA) {
+  const std::string path = "stream_plsa_test.dat";
+  {
+    std::ofstream outf(path.c_str());
+    for (int i = 0; i < 7; ++i) {
+      outf << "apple banana cherry apple\n";
+      outf << "dog eel fox dog eel\n";
+      outf << "apple dog cherry fox\n";
+    }
+  }
+
+  PLSAOptions options;
+  options.ntopics = 3;
+  DocumentSet dataset;
+  ASSERT_TRUE(dataset.Load(path));
+  EMRunner<PLSA> plsa;
+  ASSERT_TRUE(plsa.Init(options, dataset));
+
+  StreamPLSAOptions soptions;
+  soptions.ntopics = 3;
+  soptions.shard_size = 4;  // 21 documents in 6 shards, the last one partial
+  soptions.swapdir = ".";
+  EMRunner<StreamPLSA> stream;
+  ASSERT_TRUE(stream.Init(soptions, path));
+  EXPECT_EQ(dataset.DictSize(), stream.dataset().DictSize());
+
+  const std::size_t iters = 10;
+  plsa.Run(iters - 1);
+  double lik = plsa.Likelihood();
+  plsa.Step();
+  stream.Run(iters);
+  EXPECT_NEAR(lik, stream.lik(), 1e-9 * std::fabs(lik));
+  for (uint32_t w = 0; w < dataset.DictSize(); ++w) {
+    for (uint32_t z = 0; z < 3; ++z) {
+      EXPECT_NEAR(plsa.p_w_z()(w, z), stream.p_w_z()(w, z), 1e-12) << NVC_(w) << NV_(z);
+    }
+  }
+
+  std::remove(path.c_str());
+  std::remove("./corpus.bin");
+  for (int s = 0; s < 6; ++s) {
+    std::stringstream ss;
+    ss << "./p_z_d." << s << ".bin";
+    std::remove(ss.str().c_str());
+  }
+}
+
+TEST(StreamPLSA, RejectsInCoreOnlyOptions) {
+  const std::string path = "stream_plsa_test.dat";
+  {
+    std::ofstream outf(path.c_str());
+    outf << "apple banana cherry apple\n";
+    outf << "dog eel fox dog eel\n";
+  }
+  StreamPLSAOptions options;
+  options.shard_size = 4;
+  options.swapdir = ".";
+  StreamPLSA stream;
+  EXPECT_TRUE(stream.Init(options, path));
+
+  StreamPLSAOptions rejected = options;
+  rejected.block_size = 2;
+  EXPECT_FALSE(stream.Init(rejected, path));
+  rejected = options;
+  rejected.accelerate = true;
+  EXPECT_FALSE(stream.Init(rejected, path));
+  rejected = options;
+  rejected.prune_after = 5;
+  EXPECT_FALSE(stream.Init(rejected, path));
+  rejected = options;
+  rejected.lazy_interval = 5;
+  EXPECT_FALSE(stream.Init(rejected, path));
+
+  std::remove(path.c_str());
+  std::remove("./corpus.bin");
+}
+
+} /* namespace toyml */
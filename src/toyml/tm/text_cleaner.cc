@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "text_cleaner.h"
+
+#include <omp.h>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <glog/logging.h>
+
+#include <toyml/util/mapped_file.h>
+
+namespace toyml {
+
+// bytes cleaned by each thread before the output is written
+static const std::size_t kChunkSize = 16 << 20;
+
+static inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline char ToLower(char c) {
+  return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+static inline bool IsLower(char c) {
+  return c >= 'a' && c <= 'z';
+}
+
+namespace {
+
+/**
+ * @brief The Porter stemmer on b[0, k]; j marks the end of the stem tested by a suffix rule
+ */
+class Porter {
+public:
+  explicit Porter(std::string* word): b_(*word), k_(word->size() - 1), j_(0) {
+  }
+  void Stem() {
+    if (k_ <= 1) return;
+    Step1ab();
+    if (k_ > 0) {
+      Step1c();
+      Step2();
+      Step3();
+      Step4();
+      Step5();
+    }
+    b_.resize(k_ + 1);
+  }
+private:
+  std::string& b_;
+  int k_;
+  int j_;
+
+  bool Cons(int i) const {
+    switch (b_[i]) {
+    case 'a': case 'e': case 'i': case 'o': case 'u':
+      return false;
+    case 'y':
+      return i == 0 ? true : !Cons(i - 1);
+    default:
+      return true;
+    }
+  }
+  // the number of consonant-vowel sequences in b[0, j]
+  int M() const {
+    int n = 0;
+    int i = 0;
+    while (true) {
+      if (i > j_) return n;
+      if (!Cons(i)) break;
+      ++i;
+    }
+    ++i;
+    while (true) {
+      while (true) {
+        if (i > j_) return n;
+        if (Cons(i)) break;
+        ++i;
+      }
+      ++i;
+      ++n;
+      while (true) {
+        if (i > j_) return n;
+        if (!Cons(i)) break;
+        ++i;
+      }
+      ++i;
+    }
+  }
+  bool VowelInStem() const {
+    for (int i = 0; i <= j_; ++i) {
+      if (!Cons(i)) return true;
+    }
+    return false;
+  }
+  bool DoubleC(int i) const {
+    return i >= 1 && b_[i] == b_[i - 1] && Cons(i);
+  }
+  // consonant-vowel-consonant ending at i where the last one is not w, x or y
+  bool Cvc(int i) const {
+    if (i < 2 || !Cons(i) || Cons(i - 1) || !Cons(i - 2)) return false;
+    char c = b_[i];
+    return c != 'w' && c != 'x' && c != 'y';
+  }
+  bool Ends(const char* s) {
+    int len = std::strlen(s);
+    if (len > k_ + 1) return false;
+    if (b_.compare(k_ - len + 1, len, s) != 0) return false;
+    j_ = k_ - len;
+    return true;
+  }
+  void SetTo(const char* s) {
+    int len = std::strlen(s);
+    b_.replace(j_ + 1, k_ - j_, s);
+    k_ = j_ + len;
+  }
+  void R(const char* s) {
+    if (M() > 0) SetTo(s);
+  }
+
+  void Step1ab() {
+    if (b_[k_] == 's') {
+      if (Ends("sses")) {
+        k_ -= 2;
+      } else if (Ends("ies")) {
+        SetTo("i");
+      } else if (b_[k_ - 1] != 's') {
+        --k_;
+      }
+    }
+    if (Ends("eed")) {
+      if (M() > 0) --k_;
+    } else if ((Ends("ed") || Ends("ing")) && VowelInStem()) {
+      k_ = j_;
+      if (Ends("at")) {
+        SetTo("ate");
+      } else if (Ends("bl")) {
+        SetTo("ble");
+      } else if (Ends("iz")) {
+        SetTo("ize");
+      } else if (DoubleC(k_)) {
+        --k_;
+        char c = b_[k_];
+        if (c == 'l' || c == 's' || c == 'z') ++k_;
+      } else if (M() == 1 && Cvc(k_)) {
+        SetTo("e");
+      }
+    }
+  }
+  void Step1c() {
+    if (Ends("y") && VowelInStem()) b_[k_] = 'i';
+  }
+  void Step2() {
+    switch (b_[k_ - 1]) {
+    case 'a':
+      if (Ends("ational")) { R("ate"); break; }
+      if (Ends("tional")) { R("tion"); break; }
+      break;
+    case 'c':
+      if (Ends("enci")) { R("ence"); break; }
+      if (Ends("anci")) { R("ance"); break; }
+      break;
+    case 'e':
+      if (Ends("izer")) { R("ize"); break; }
+      break;
+    case 'l':
+      if (Ends("bli")) { R("ble"); break; }
+      if (Ends("alli")) { R("al"); break; }
+      if (Ends("entli")) { R("ent"); break; }
+      if (Ends("eli")) { R("e"); break; }
+      if (Ends("ousli")) { R("ous"); break; }
+      break;
+    case 'o':
+      if (Ends("ization")) { R("ize"); break; }
+      if (Ends("ation")) { R("ate"); break; }
+      if (Ends("ator")) { R("ate"); break; }
+      break;
+    case 's':
+      if (Ends("alism")) { R("al"); break; }
+      if (Ends("iveness")) { R("ive"); break; }
+      if (Ends("fulness")) { R("ful"); break; }
+      if (Ends("ousness")) { R("ous"); break; }
+      break;
+    case 't':
+      if (Ends("aliti")) { R("al"); break; }
+      if (Ends("iviti")) { R("ive"); break; }
+      if (Ends("biliti")) { R("ble"); break; }
+      break;
+    case 'g':
+      if (Ends("logi")) { R("log"); break; }
+      break;
+    }
+  }
+  void Step3() {
+    switch (b_[k_]) {
+    case 'e':
+      if (Ends("icate")) { R("ic"); break; }
+      if (Ends("ative")) { R(""); break; }
+      if (Ends("alize")) { R("al"); break; }
+      break;
+    case 'i':
+      if (Ends("iciti")) { R("ic"); break; }
+      break;
+    case 'l':
+      if (Ends("ical")) { R("ic"); break; }
+      if (Ends("ful")) { R(""); break; }
+      break;
+    case 's':
+      if (Ends("ness")) { R(""); break; }
+      break;
+    }
+  }
+  void Step4() {
+    switch (b_[k_ - 1]) {
+    case 'a':
+      if (Ends("al")) break;
+      return;
+    case 'c':
+      if (Ends("ance")) break;
+      if (Ends("ence")) break;
+      return;
+    case 'e':
+      if (Ends("er")) break;
+      return;
+    case 'i':
+      if (Ends("ic")) break;
+      return;
+    case 'l':
+      if (Ends("able")) break;
+      if (Ends("ible")) break;
+      return;
+    case 'n':
+      if (Ends("ant")) break;
+      if (Ends("ement")) break;
+      if (Ends("ment")) break;
+      if (Ends("ent")) break;
+      return;
+    case 'o':
+      if (Ends("ion") && j_ >= 0 && (b_[j_] == 's' || b_[j_] == 't')) break;
+      if (Ends("ou")) break;
+      return;
+    case 's':
+      if (Ends("ism")) break;
+      return;
+    case 't':
+      if (Ends("ate")) break;
+      if (Ends("iti")) break;
+      return;
+    case 'u':
+      if (Ends("ous")) break;
+      return;
+    case 'v':
+      if (Ends("ive")) break;
+      return;
+    case 'z':
+      if (Ends("ize")) break;
+      return;
+    default:
+      return;
+    }
+    if (M() > 1) k_ = j_;
+  }
+  void Step5() {
+    j_ = k_;
+    if (b_[k_] == 'e') {
+      int m = M();
+      if (m > 1 || (m == 1 && !Cvc(k_ - 1))) --k_;
+    }
+    if (b_[k_] == 'l' && DoubleC(k_) && M() > 1) --k_;
+  }
+};
+
+}  // namespace
+
+bool TextCleaner::Init(const TextCleanerOptions& options) {
+  options_ = options;
+  stopwords_.clear();
+  if (!options_.stopwords.empty()) {
+    std::ifstream inf(options_.stopwords.c_str());
+    if (!inf) {
+      LOG(ERROR) << "Failed to open stopword file " << options_.stopwords;
+      return false;
+    }
+    std::string word;
+    while (inf >> word) {
+      stopwords_.insert(word);
+    }
+  }
+  return true;
+}
+
+void TextCleaner::Stem(std::string* word) {
+  if (!word->empty()) {
+    Porter(word).Stem();
+  }
+}
+
+std::size_t TextCleaner::CleanLine(const char* begin, const char* end, std::string* out) const {
+  std::size_t ntokens = 0;
+  std::string token;
+  for (const char* p = begin; p < end; ) {
+    while (p < end && IsSpace(*p)) ++p;
+    const char* b = p;
+    while (p < end && !IsSpace(*p)) ++p;
+    if (b == p) break;
+
+    token.assign(b, p);
+    bool valid = true;
+    for (std::size_t i = 0; i < token.size(); ++i) {
+      token[i] = ToLower(token[i]);
+      if (i + 1 < token.size() && !IsLower(token[i])) {
+        valid = false;
+        break;
+      }
+    }
+    if (!valid) continue;
+    if (!IsLower(token[token.size() - 1])) {
+      token.resize(token.size() - 1);
+    }
+    if (token.size() < options_.min_length || stopwords_.count(token)) continue;
+    if (options_.stem) {
+      Stem(&token);
+    }
+
+    if (ntokens > 0) {
+      out->push_back(' ');
+    }
+    out->append(token);
+    ++ntokens;
+  }
+  return ntokens;
+}
+
+std::size_t TextCleaner::CleanLines(const char* begin, const char* end, std::string* out,
+    std::size_t* ntokens) const {
+  std::size_t ndocs = 0;
+  for (const char* p = begin; p < end; ) {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    const char* e = eol ? eol : end;
+    std::size_t n = CleanLine(p, e, out);
+    if (n > 0) {
+      out->push_back('\n');
+      *ntokens += n;
+      ++ndocs;
+    }
+    p = e + 1;
+  }
+  return ndocs;
+}
+
+bool TextCleaner::CleanFile(const std::string& inpath, const std::string& outpath,
+    std::size_t* ndocs, std::size_t* ntokens) const {
+  MappedFile file;
+  if (!file.Open(inpath)) {
+    LOG(ERROR) << "Failed to open " << inpath;
+    return false;
+  }
+  std::ofstream outf(outpath.c_str(), std::ios::binary);
+  if (!outf) {
+    LOG(ERROR) << "Failed to create " << outpath;
+    return false;
+  }
+
+  const char* text = file.data();
+  const char* text_end = text + file.size();
+  std::size_t nthreads = options_.threads ? options_.threads : omp_get_max_threads();
+  std::vector<std::string> outs(nthreads);
+  std::vector<std::size_t> docs(nthreads);
+  std::vector<std::size_t> tokens(nthreads);
+  std::vector<const char*> bounds(nthreads + 1);
+  std::size_t total_docs = 0;
+  std::size_t total_tokens = 0;
+
+  // Each round cleans up to nthreads * kChunkSize bytes, split into one
+  // chunk of whole lines per thread, and writes the chunks in input order.
+  for (const char* begin = text; begin < text_end; begin = bounds[nthreads]) {
+    bounds[0] = begin;
+    for (std::size_t c = 1; c <= nthreads; ++c) {
+      const char* b = std::min(bounds[c - 1] + kChunkSize, text_end);
+      if (b < text_end) {
+        const void* eol = std::memchr(b, '\n', text_end - b);
+        b = eol ? static_cast<const char*>(eol) + 1 : text_end;
+      }
+      bounds[c] = b;
+    }
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+    for (std::size_t c = 0; c < nthreads; ++c) {
+      outs[c].clear();
+      tokens[c] = 0;
+      docs[c] = CleanLines(bounds[c], bounds[c + 1], &outs[c], &tokens[c]);
+    }
+    for (std::size_t c = 0; c < nthreads; ++c) {
+      outf.write(outs[c].data(), outs[c].size());
+      total_docs += docs[c];
+      total_tokens += tokens[c];
+    }
+  }
+
+  if (ndocs) *ndocs = total_docs;
+  if (ntokens) *ntokens = total_tokens;
+  outf.close();
+  if (!outf) {
+    LOG(ERROR) << "Failed to write " << outpath;
+    return false;
+  }
+  return true;
+}
+
+} /* namespace toyml */
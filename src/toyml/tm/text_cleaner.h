@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef TEXT_CLEANER_H_
+#define TEXT_CLEANER_H_
+
+#include <string>
+#include <sstream>
+#include <boost/unordered_set.hpp>
+
+#include <toyml/tm/utils.h>
+
+namespace toyml {
+
+/**
+ * @brief Text cleaner options
+ */
+struct TextCleanerOptions {
+  std::string stopwords;   // path of a whitespace separated stopword list, empty means none
+  bool stem;               // whether to reduce tokens to their Porter stems
+  std::size_t min_length;  // drop tokens shorter than this
+  std::size_t threads;     // number of threads, 0 means using all the cores
+  TextCleanerOptions() :
+      stem(false), min_length(2), threads(0) {
+  }
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << NVC_(stopwords) << NVC_(stem) << NVC_(min_length) << NV_(threads);
+    return ss.str();
+  }
+};
+
+/**
+ * @brief Turns raw text into the whitespace document format of DocumentSet::Load
+ *
+ * Every line is a document. It is lowercased and split at whitespace, and a
+ * token is kept only if all its characters but the last are ASCII letters;
+ * a trailing punctuation character is stripped. Short tokens and stopwords
+ * are dropped and the rest are optionally stemmed. Lines left without
+ * tokens are skipped. These are the rules of tool/clean_docs.py.
+ */
+class TextCleaner {
+public:
+  bool Init(const TextCleanerOptions& options);
+  // Appends the cleaned tokens of [begin, end) to out separated by spaces,
+  // and returns the number of tokens
+  std::size_t CleanLine(const char* begin, const char* end, std::string* out) const;
+  // Cleans inpath line by line in parallel blocks and writes the non-empty
+  // documents to outpath in input order
+  bool CleanFile(const std::string& inpath, const std::string& outpath,
+      std::size_t* ndocs = NULL, std::size_t* ntokens = NULL) const;
+  // Reduces a lowercase word to its stem with the Porter (1980) algorithm
+  static void Stem(std::string* word);
+private:
+  TextCleanerOptions options_;
+  boost::unordered_set<std::string> stopwords_;
+
+  std::size_t CleanLines(const char* begin, const char* end, std::string* out,
+      std::size_t* ntokens) const;
+};
+
+} /* namespace toyml */
+#endif /* TEXT_CLEANER_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012 Binson Zhang. All rights reserved.
+ *
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "text_cleaner.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+namespace {
+
+std::string Clean(const TextCleaner& cleaner, const char* line, std::size_t* ntokens) {
+  std::string out;
+  *ntokens = cleaner.CleanLine(line, line + std::strlen(line), &out);
+  return out;
+}
+
+}  // namespace
+
+// The rules of tool/clean_docs.py
+TEST(TextCleaner, CleanLine) {
+  TextCleaner cleaner;
+  ASSERT_TRUE(cleaner.Init(TextCleanerOptions()));
+  std::size_t ntokens = 0;
+  // lowercased; a trailing non-letter is stripped; a non-letter elsewhere
+  // drops the token, and so do single letters
+  EXPECT_EQ("the quick brown jumps ok",
+      Clean(cleaner, "The Quick, brown fox's co-op JUMPS! a I'm ok. 42 x1 hello!!", &ntokens));
+  EXPECT_EQ(5u, ntokens);
+  EXPECT_EQ("tab separated words",
+      Clean(cleaner, "\tTab\tseparated \r\f words\v", &ntokens));
+  EXPECT_EQ(3u, ntokens);
+  EXPECT_EQ("", Clean(cleaner, "  ", &ntokens));
+  EXPECT_EQ(0u, ntokens);
+  EXPECT_EQ("", Clean(cleaner, "", &ntokens));
+  EXPECT_EQ(0u, ntokens);
+
+  // stopwords are matched after stripping, and tokens shorter than min_length are dropped
+  const std::string path = "text_cleaner_test.stop";
+  {
+    std::ofstream outf(path.c_str());
+    outf << "the ok\nbrown\n";
+  }
+  TextCleanerOptions options;
+  options.stopwords = path;
+  options.min_length = 4;
+  ASSERT_TRUE(cleaner.Init(options));
+  EXPECT_EQ("quick jumps",
+      Clean(cleaner, "The Quick, brown fox's co-op JUMPS! a I'm ok. 42 x1 hello!!", &ntokens));
+  EXPECT_EQ(2u, ntokens);
+  std::remove(path.c_str());
+
+  options.stopwords = "no_such_file";
+  EXPECT_FALSE(cleaner.Init(options));
+
+  options = TextCleanerOptions();
+  options.stem = true;
+  ASSERT_TRUE(cleaner.Init(options));
+  EXPECT_EQ("caress poni connect", Clean(cleaner, "Caresses ponies, connections.", &ntokens));
+  EXPECT_EQ(3u, ntokens);
+}
+
+TEST(TextCleaner, Stem) {
+  // from the sample vocabulary of the Porter stemmer
+  const char* pairs[][2] = {
+    {"caresses", "caress"}, {"ponies", "poni"}, {"ties", "ti"}, {"caress", "caress"},
+    {"cats", "cat"}, {"feed", "feed"}, {"agreed", "agre"}, {"plastered", "plaster"},
+    {"bled", "bled"}, {"motoring", "motor"}, {"sing", "sing"}, {"conflated", "conflat"},
+    {"troubled", "troubl"}, {"sized", "size"}, {"hopping", "hop"}, {"tanned", "tan"},
+    {"falling", "fall"}, {"hissing", "hiss"}, {"fizzed", "fizz"}, {"failing", "fail"},
+    {"filing", "file"}, {"happy", "happi"}, {"sky", "sky"}, {"relational", "relat"},
+    {"conditional", "condit"}, {"hopefulness", "hope"}, {"electrical", "electr"},
+    {"adjustment", "adjust"}, {"generalizations", "gener"}, {"oscillators", "oscil"},
+    {"connected", "connect"}, {"connecting", "connect"}, {"connection", "connect"},
+    {"is", "is"}, {"a", "a"}, {"", ""},
+  };
+  for (std::size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); ++i) {
+    std::string word = pairs[i][0];
+    TextCleaner::Stem(&word);
+    EXPECT_EQ(pairs[i][1], word) << pairs[i][0];
+  }
+}
+
+} /* namespace toyml */
@@ -6,7 +6,10 @@
  */
 
 #include "utils.h"
+#include <cmath>
 #include <fstream>
+#include <algorithm>
+#include <functional>
 #include <glog/logging.h>
 
 namespace toyml {
@@ -36,4 +39,60 @@ bool Utils::SaveMatrix(const ublas::matrix<double>& mat,
   return true;
 }
 
+double Utils::Digamma(double x) {
+  double r = 0;
+  while (x < 6) {
+    r -= 1 / x;
+    x += 1;
+  }
+  double f = 1 / (x * x);
+  double t = f * (-1 / 12.0 + f * (1 / 120.0 + f * (-1 / 252.0 + f * (1 / 240.0 + f * (-1 / 132.0)))));
+  return r + log(x) - 0.5 / x + t;
+}
+
+void Utils::TopK(const double* values, std::size_t n, std::size_t stride,
+    std::size_t k, std::vector<ProbId>* top) {
+  // min-heap of the k largest values seen so far, so a scan costs O(n log k)
+  // instead of sorting all n values
+  top->clear();
+  if (k == 0) {
+    return;
+  }
+  top->reserve(std::min(n, k));
+  std::greater<ProbId> greater;
+  for (std::size_t i = 0; i < n; ++i) {
+    ProbId item(values[i * stride], i);
+    if (top->size() < k) {
+      top->push_back(item);
+      std::push_heap(top->begin(), top->end(), greater);
+    } else if (greater(item, top->front())) {
+      std::pop_heap(top->begin(), top->end(), greater);
+      top->back() = item;
+      std::push_heap(top->begin(), top->end(), greater);
+    }
+  }
+  std::sort_heap(top->begin(), top->end(), greater);
+}
+
+void Utils::TopK(const ublas::matrix<double>& mat, bool by_column, std::size_t k,
+    std::vector<std::vector<ProbId> >* tops) {
+  std::size_t ntops = by_column ? mat.size2() : mat.size1();
+  std::size_t n = by_column ? mat.size1() : mat.size2();
+  tops->resize(ntops);
+  if (n == 0) {
+    for (std::size_t i = 0; i < ntops; ++i) {
+      (*tops)[i].clear();
+    }
+    return;
+  }
+#pragma omp parallel for schedule(dynamic)
+  for (std::size_t i = 0; i < ntops; ++i) {
+    if (by_column) {
+      TopK(&mat(0, i), n, mat.size2(), k, &(*tops)[i]);
+    } else {
+      TopK(&mat(i, 0), n, 1, k, &(*tops)[i]);
+    }
+  }
+}
+
 } /* namespace toyml */
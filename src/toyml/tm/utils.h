@@ -9,6 +9,9 @@
 #define UTILS_H_
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <stdint.h>
 #include <boost/numeric/ublas/matrix.hpp>
 
 namespace toyml {
@@ -25,11 +28,21 @@ namespace ublas = boost::numeric::ublas;
  */
 class Utils {
 public:
+  typedef std::pair<double, uint32_t> ProbId;
+
   Utils();
   virtual ~Utils();
 
   static bool SaveMatrix(const ublas::matrix<double>& mat,
       const std::string& path);
+  // digamma function, i.e. the derivative of log(gamma(x)), for x > 0
+  static double Digamma(double x);
+  // the k largest of n values stored stride apart, in descending order
+  static void TopK(const double* values, std::size_t n, std::size_t stride,
+      std::size_t k, std::vector<ProbId>* top);
+  // the k largest values of every column (by_column) or row of mat, selected in parallel
+  static void TopK(const ublas::matrix<double>& mat, bool by_column, std::size_t k,
+      std::vector<std::vector<ProbId> >* tops);
 };
 
 } /* namespace toyml */
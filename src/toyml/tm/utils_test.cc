@@ -6,7 +6,84 @@
  */
 
 #include "utils.h"
+#include <algorithm>
+#include <functional>
+#include <gtest/gtest.h>
 
 namespace toyml {
 
+namespace {
+
+typedef Utils::ProbId ProbId;
+
+// The first k of a full descending sort of (value, id) pairs
+std::vector<ProbId> SortTopK(const std::vector<double>& values, std::size_t k) {
+  std::vector<ProbId> all;
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    all.push_back(ProbId(values[i], i));
+  }
+  std::sort(all.begin(), all.end(), std::greater<ProbId>());
+  all.resize(std::min(k, all.size()));
+  return all;
+}
+
+}  // namespace
+
+TEST(Utils, TopK) {
+  std::vector<ProbId> top;
+  const double values[] = {0.3, 0.1, 0.2};
+  Utils::TopK(values, 3, 1, 5, &top);
+  ASSERT_EQ(3u, top.size());
+  EXPECT_EQ(ProbId(0.3, 0), top[0]);
+  EXPECT_EQ(ProbId(0.2, 2), top[1]);
+  EXPECT_EQ(ProbId(0.1, 1), top[2]);
+
+  Utils::TopK(values, 3, 1, 0, &top);
+  EXPECT_TRUE(top.empty());
+
+  // ties go to the larger id, as in a descending sort of the pairs
+  const double ties[] = {1, 2, 2, 1, 2};
+  Utils::TopK(ties, 5, 1, 2, &top);
+  ASSERT_EQ(2u, top.size());
+  EXPECT_EQ(ProbId(2, 4), top[0]);
+  EXPECT_EQ(ProbId(2, 2), top[1]);
+
+  // every other value, i.e. {1, 2, 2}
+  Utils::TopK(ties, 3, 2, 2, &top);
+  ASSERT_EQ(2u, top.size());
+  EXPECT_EQ(ProbId(2, 2), top[0]);
+  EXPECT_EQ(ProbId(2, 1), top[1]);
+}
+
+TEST(Utils, MatrixTopK) {
+  const std::size_t rows = 7, cols = 4;
+  ublas::matrix<double> mat(rows, cols);
+  for (std::size_t i = 0; i < rows; ++i) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      mat(i, j) = (i * 5 + j * 3) % 6;  // with ties
+    }
+  }
+  const std::size_t ks[] = {0, 3, 10};
+  for (std::size_t t = 0; t < sizeof(ks) / sizeof(ks[0]); ++t) {
+    SCOPED_TRACE(ks[t]);
+    std::vector<std::vector<ProbId> > tops;
+    Utils::TopK(mat, true, ks[t], &tops);
+    ASSERT_EQ(cols, tops.size());
+    for (std::size_t j = 0; j < cols; ++j) {
+      std::vector<double> column(rows);
+      for (std::size_t i = 0; i < rows; ++i) {
+        column[i] = mat(i, j);
+      }
+      EXPECT_EQ(SortTopK(column, ks[t]), tops[j]) << "column " << j;
+    }
+
+    Utils::TopK(mat, false, ks[t], &tops);
+    ASSERT_EQ(rows, tops.size());
+    for (std::size_t i = 0; i < rows; ++i) {
+      std::vector<double> row(mat.data().begin() + i * cols, mat.data().begin() + (i + 1) * cols);
+      EXPECT_EQ(SortTopK(row, ks[t]), tops[i]) << "row " << i;
+    }
+  }
+}
+
 } /* namespace toyml */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef TOYML_UTIL_GEMM_H_
+#define TOYML_UTIL_GEMM_H_
+
+#include <cstddef>
+#include <algorithm>
+#ifdef TOYML_USE_CBLAS
+#include <cblas.h>
+#endif
+
+namespace toyml {
+
+/**
+ * @brief General matrix multiplication of row-major matrices
+ *
+ * C = alpha * op(A) * op(B) + beta * C, where op(A) is m x k, op(B) is k x n
+ * and op(X) is X or its transpose. lda, ldb and ldc are the row strides.
+ *
+ * Calls cblas_dgemm if TOYML_USE_CBLAS is defined. Otherwise the product is
+ * computed in KC x NC panels of op(B), which stay in cache while every row of
+ * op(A) is applied to them. The innermost loop walks contiguous memory except
+ * when both A and B are transposed, where A is read with stride lda. The
+ * kernel does no allocation.
+ */
+inline void Gemm(bool trans_a, bool trans_b, std::size_t m, std::size_t n, std::size_t k,
+    double alpha, const double* a, std::size_t lda, const double* b, std::size_t ldb,
+    double beta, double* c, std::size_t ldc) {
+#ifdef TOYML_USE_CBLAS
+  cblas_dgemm(CblasRowMajor, trans_a ? CblasTrans : CblasNoTrans,
+      trans_b ? CblasTrans : CblasNoTrans, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+#else
+  static const std::size_t kKC = 128;
+  static const std::size_t kNC = 256;
+
+  for (std::size_t i = 0; i < m; ++i) {
+    double* ci = c + i * ldc;
+    for (std::size_t j = 0; j < n; ++j) {
+      ci[j] = beta == 0 ? 0 : beta * ci[j];
+    }
+  }
+  for (std::size_t kk = 0; kk < k; kk += kKC) {
+    std::size_t kend = std::min(kk + kKC, k);
+    for (std::size_t jj = 0; jj < n; jj += kNC) {
+      std::size_t jend = std::min(jj + kNC, n);
+      for (std::size_t i = 0; i < m; ++i) {
+        double* ci = c + i * ldc;
+        if (!trans_b) {
+          // rows of B are contiguous: C(i, :) += A(i, p) * B(p, :)
+          for (std::size_t p = kk; p < kend; ++p) {
+            double aip = alpha * (trans_a ? a[p * lda + i] : a[i * lda + p]);
+            if (aip == 0) continue;
+            const double* bp = b + p * ldb;
+            for (std::size_t j = jj; j < jend; ++j) {
+              ci[j] += aip * bp[j];
+            }
+          }
+        } else if (!trans_a) {
+          // rows of A and B are contiguous: C(i, j) += A(i, :) . B(j, :)
+          const double* ai = a + i * lda;
+          for (std::size_t j = jj; j < jend; ++j) {
+            const double* bj = b + j * ldb;
+            double sum = 0;
+            for (std::size_t p = kk; p < kend; ++p) {
+              sum += ai[p] * bj[p];
+            }
+            ci[j] += alpha * sum;
+          }
+        } else {
+          for (std::size_t j = jj; j < jend; ++j) {
+            const double* bj = b + j * ldb;
+            double sum = 0;
+            for (std::size_t p = kk; p < kend; ++p) {
+              sum += a[p * lda + i] * bj[p];
+            }
+            ci[j] += alpha * sum;
+          }
+        }
+      }
+    }
+  }
+#endif
+}
+
+} /* namespace toyml */
+#endif /* TOYML_UTIL_GEMM_H_ */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "gemm.h"
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+namespace {
+
+// Reference product of row-major matrices
+void NaiveGemm(bool trans_a, bool trans_b, std::size_t m, std::size_t n, std::size_t k,
+    double alpha, const std::vector<double>& a, const std::vector<double>& b,
+    double beta, std::vector<double>* c) {
+  for (std::size_t i = 0; i < m; ++i) {
+    for (std::size_t j = 0; j < n; ++j) {
+      double sum = 0;
+      for (std::size_t p = 0; p < k; ++p) {
+        sum += (trans_a ? a[p * m + i] : a[i * k + p]) * (trans_b ? b[j * k + p] : b[p * n + j]);
+      }
+      (*c)[i * n + j] = alpha * sum + beta * (*c)[i * n + j];
+    }
+  }
+}
+
+}  // namespace
+
+TEST(Gemm, Transposes) {
+  // larger than a panel in every dimension
+  const std::size_t m = 37, n = 301, k = 259;
+  std::vector<double> a(m * k), b(k * n), c0(m * n);
+  for (std::size_t i = 0; i < a.size(); ++i) a[i] = std::rand() % 7 - 3;
+  for (std::size_t i = 0; i < b.size(); ++i) b[i] = std::rand() % 5 - 2;
+  for (std::size_t i = 0; i < c0.size(); ++i) c0[i] = std::rand() % 3;
+  for (int t = 0; t < 4; ++t) {
+    bool trans_a = t & 1, trans_b = t & 2;
+    std::vector<double> expected = c0, actual = c0;
+    NaiveGemm(trans_a, trans_b, m, n, k, 0.5, a, b, 2, &expected);
+    Gemm(trans_a, trans_b, m, n, k, 0.5, &a[0], trans_a ? m : k, &b[0], trans_b ? k : n,
+        2, &actual[0], n);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_DOUBLE_EQ(expected[i], actual[i]) << "trans_a=" << trans_a << ", trans_b=" << trans_b;
+    }
+  }
+}
+
+} /* namespace toyml */
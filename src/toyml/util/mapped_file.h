@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#ifndef TOYML_UTIL_MAPPED_FILE_H_
+#define TOYML_UTIL_MAPPED_FILE_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+
+namespace toyml {
+
+/**
+ * @brief A file mapped into memory with mmap
+ */
+class MappedFile {
+ public:
+  MappedFile(): data_(NULL), size_(0), open_(false), writable_(false) {}
+  virtual ~MappedFile() { Close(); }
+
+  /**
+   * @brief Maps an existing file read-only
+   */
+  bool Open(const std::string& path) {
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ret = fstat(fd, &st) == 0 && Map(fd, st.st_size, PROT_READ);
+    close(fd);
+    return ret;
+  }
+  /**
+   * @brief Creates or truncates a file of size bytes and maps it read-write
+   */
+  bool Create(const std::string& path, std::size_t size) {
+    Close();
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ret = ftruncate(fd, size) == 0 && Map(fd, size, PROT_READ | PROT_WRITE);
+    close(fd);
+    writable_ = ret;
+    return ret;
+  }
+  /**
+   * @brief Maps an existing file read-write
+   */
+  bool OpenWritable(const std::string& path) {
+    Close();
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ret = fstat(fd, &st) == 0 && Map(fd, st.st_size, PROT_READ | PROT_WRITE);
+    close(fd);
+    writable_ = ret;
+    return ret;
+  }
+  void Close() {
+    if (data_ != NULL) {
+      munmap(data_, size_);
+    }
+    data_ = NULL;
+    size_ = 0;
+    open_ = false;
+    writable_ = false;
+  }
+
+  bool is_open() const { return open_; }
+  std::size_t size() const { return size_; }
+  const char* data() const { return data_; }
+  char* mutable_data() { return writable_ ? data_ : NULL; }
+ private:
+  char* data_;
+  std::size_t size_;
+  bool open_;
+  bool writable_;
+
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  bool Map(int fd, std::size_t size, int prot) {
+    if (size > 0) {
+      void* addr = mmap(NULL, size, prot, MAP_SHARED, fd, 0);
+      if (addr == MAP_FAILED) return false;
+      data_ = static_cast<char*>(addr);
+    }
+    size_ = size;
+    open_ = true;
+    return true;
+  }
+};
+
+} /* namespace toyml */
+#endif /* TOYML_UTIL_MAPPED_FILE_H_ */
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2013 Binson Zhang.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @author	Binson Zhang <bin183cs@gmail.com>
+ * @date		2026-10-19
+ */
+
+#include "mapped_file.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+namespace toyml {
+
+TEST(MappedFile, CreateAndOpen) {
+  const std::string path = "mapped_file_test.dat";
+  MappedFile file;
+  EXPECT_FALSE(file.is_open());
+  EXPECT_FALSE(file.Open("null/null"));
+  ASSERT_TRUE(file.Create(path, 6));
+  EXPECT_EQ(6U, file.size());
+  std::memcpy(file.mutable_data(), "toyml", 6);
+  file.Close();
+
+  ASSERT_TRUE(file.Open(path));
+  EXPECT_TRUE(file.is_open());
+  EXPECT_TRUE(file.mutable_data() == NULL);
+  EXPECT_STREQ("toyml", file.data());
+  file.Close();
+  unlink(path.c_str());
+}
+
+} /* namespace toyml */
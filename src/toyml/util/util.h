@@ -26,7 +26,11 @@
 #ifndef TOYML_UTIL_UTIL_H_
 #define TOYML_UTIL_UTIL_H_
 
+#include <cmath>
+#include <limits>
+#include <cstring>
 #include <algorithm>
+#include <stdint.h>
 
 #include <toyml/common/common.h>
 
@@ -38,20 +42,129 @@ namespace toyml {
 #define NVC_ NAME_VAL_COMMA
 
 /**
- * @brief 
+ * @brief Numeric kernels on contiguous buffers
+ *
+ * The activation kernels are written as branch-free "omp simd" loops around
+ * FastExp, whose relative error is below 1e-13 over the whole double range.
  */
 class Util {
  public:
+  /**
+   * @brief exp(x) by range reduction x = n * ln2 + r, |r| <= ln2 / 2, and a
+   * degree 11 Taylor polynomial of exp(r)
+   *
+   * Results below the smallest normal double are 0, those above the largest
+   * double are inf. Only integer masks select the special cases, so loops
+   * over FastExp vectorize.
+   */
+  static double FastExp(double x) {
+    // adding 1.5 * 2^52 rounds x / ln2 to the nearest integer n and leaves n in the low bits
+    const double kShifter = 6755399441055744.0;
+    double t = x * 1.4426950408889634 + kShifter;
+    double n = t - kShifter;
+    // ln2 split in two so that n * 0.693145751953125 is exact
+    double r = x - n * 0.693145751953125 - n * 1.42860682030941723212e-6;
+    double p = 1.0 / 39916800;
+    p = p * r + 1.0 / 3628800;
+    p = p * r + 1.0 / 362880;
+    p = p * r + 1.0 / 40320;
+    p = p * r + 1.0 / 5040;
+    p = p * r + 1.0 / 720;
+    p = p * r + 1.0 / 120;
+    p = p * r + 1.0 / 24;
+    p = p * r + 1.0 / 6;
+    p = p * r + 0.5;
+    p = p * r + 1;
+    p = p * r + 1;
+    // p * 2^n with the biased exponent e clamped to the normal range
+    int64_t e = Bits(t) - Bits(kShifter) + 1023;
+    int64_t under = (e - 1) >> 63;    // all ones if e < 1
+    int64_t over = (2046 - e) >> 63;  // all ones if e > 2046
+    int64_t scale = (e & ~under & ~over) | (over & 2046);
+    int64_t y = Bits(p * Double(scale << 52));
+    return Double((y & ~under & ~over) | (over & 0x7ff0000000000000LL));
+  }
+
+  // x[i] = exp(x[i])
+  static void Exp(double* x, std::size_t n) {
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = FastExp(x[i]);
+    }
+  }
+
   static void Softmax(RealVector& x) {
-    double max = *std::max_element(x.begin(), x.end());
+    if (x.size() > 0) Softmax(&x[0], x.size());
+  }
+  static void Softmax(double* x, std::size_t n) {
+    double max = Max(x, n);
     double sum = 0;
-    for (std::size_t i = 0; i < x.size(); ++i) {
-      x(i) = exp(x(i) - max);
-      sum += x(i);
+#pragma omp simd reduction(+: sum)
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = FastExp(x[i] - max);
+      sum += x[i];
     }
-    for (std::size_t i = 0; i < x.size(); ++i) {
-      x(i) /= sum;
+    double inv = 1 / sum;
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] *= inv;
+    }
+  }
+  // softmax of every row of the row-major rows x cols matrix x
+  static void Softmax(double* x, std::size_t rows, std::size_t cols) {
+    for (std::size_t r = 0; r < rows; ++r) {
+      Softmax(x + r * cols, cols);
+    }
+  }
+
+  // log(sum(exp(x[i]))), -inf for n = 0
+  static double LogSumExp(const double* x, std::size_t n) {
+    if (n == 0) return -std::numeric_limits<double>::infinity();
+    double max = Max(x, n);
+    if (std::isinf(max)) return max;
+    double sum = 0;
+#pragma omp simd reduction(+: sum)
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += FastExp(x[i] - max);
     }
+    return max + std::log(sum);
+  }
+
+  // x[i] = 1 / (1 + exp(-x[i]))
+  static void Sigmoid(double* x, std::size_t n) {
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = 1 / (1 + FastExp(-x[i]));
+    }
+  }
+
+  // x[i] = max(x[i], 0)
+  static void Relu(double* x, std::size_t n) {
+#pragma omp simd
+    for (std::size_t i = 0; i < n; ++i) {
+      x[i] = x[i] > 0 ? x[i] : 0;
+    }
+  }
+
+  static double Max(const double* x, std::size_t n) {
+    double max = -std::numeric_limits<double>::infinity();
+#pragma omp simd reduction(max: max)
+    for (std::size_t i = 0; i < n; ++i) {
+      max = x[i] > max ? x[i] : max;
+    }
+    return max;
+  }
+
+ private:
+  static int64_t Bits(double d) {
+    int64_t i;
+    std::memcpy(&i, &d, sizeof(i));
+    return i;
+  }
+  static double Double(int64_t i) {
+    double d;
+    std::memcpy(&d, &i, sizeof(d));
+    return d;
   }
 };
 
@@ -24,12 +24,69 @@
  */
 
 #include "util.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
 #include <gtest/gtest.h>
 
 namespace toyml {
 
-TEST(Util, Method) {
+TEST(Util, FastExp) {
+  for (double x = -708; x <= 709; x += 0.0137) {
+    double expected = std::exp(x);
+    EXPECT_NEAR(expected, Util::FastExp(x), 1e-13 * expected) << "x=" << x;
+  }
+  EXPECT_EQ(0, Util::FastExp(-800));
+  EXPECT_EQ(0, Util::FastExp(-std::numeric_limits<double>::infinity()));
+  EXPECT_TRUE(std::isinf(Util::FastExp(710)));
+  EXPECT_TRUE(std::isinf(Util::FastExp(std::numeric_limits<double>::infinity())));
+}
+
+TEST(Util, Softmax) {
+  const std::size_t rows = 10, cols = 10;
+  std::vector<double> x(rows * cols);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    x[i] = std::rand() % 2000 / 10.0 - 100;
+  }
+  // softmax of every row with std::exp, shifted by the row max
+  std::vector<double> expected(x);
+  for (std::size_t r = 0; r < rows; ++r) {
+    double* e = &expected[r * cols];
+    double max = *std::max_element(e, e + cols);
+    double sum = 0;
+    for (std::size_t i = 0; i < cols; ++i) {
+      e[i] = std::exp(e[i] - max);
+      sum += e[i];
+    }
+    for (std::size_t i = 0; i < cols; ++i) {
+      e[i] /= sum;
+    }
+  }
+  Util::Softmax(&x[0], rows, cols);
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    EXPECT_NEAR(expected[i], x[i], 1e-13) << "row=" << i / cols << ", col=" << i % cols;
+  }
+}
+
+TEST(Util, LogSumExp) {
+  double x[] = {-1000, -1001, -1002};
+  double expected = -1000 + std::log(1 + std::exp(-1.0) + std::exp(-2.0));
+  EXPECT_NEAR(expected, Util::LogSumExp(x, 3), 1e-12);
+  EXPECT_TRUE(std::isinf(Util::LogSumExp(x, 0)));
+}
 
+TEST(Util, SigmoidRelu) {
+  const double v[] = {-50, -1, 0, 1, 50};
+  double x[5], y[5];
+  std::copy(v, v + 5, x);
+  std::copy(v, v + 5, y);
+  Util::Sigmoid(x, 5);
+  Util::Relu(y, 5);
+  for (std::size_t i = 0; i < 5; ++i) {
+    EXPECT_NEAR(1 / (1 + std::exp(-v[i])), x[i], 1e-15);
+    EXPECT_EQ(std::max(v[i], 0.0), y[i]);
+  }
 }
 
 } /* namespace toyml */